@@ -0,0 +1,188 @@
+/**
+ * Core - Configuration
+ *
+ * (c) 2018 Claude Barthels, ETH Zurich
+ * Contact: claudeb@inf.ethz.ch
+ *
+ */
+
+#ifndef CORE_CONFIGURATION_H_
+#define CORE_CONFIGURATION_H_
+
+#include <stdint.h>
+#include <infiniband/verbs.h>
+
+namespace infinity {
+namespace core {
+
+class Configuration {
+
+public:
+
+	/**
+	 * Queue length settings (defaults for the runtime settings below)
+	 */
+
+	static const uint32_t SEND_COMPLETION_QUEUE_LENGTH = 16351; 		// Must be less than MAX_CQE
+
+	static const uint32_t RECV_COMPLETION_QUEUE_LENGTH = 16351; 		// Must be less than MAX_CQE
+
+	static const uint32_t SHARED_RECV_QUEUE_LENGTH = 16351; 			// Must be less than MAX_SRQ_WR
+
+	static const uint32_t MAX_NUMBER_OF_OUTSTANDING_REQUESTS = 16351;	// Must be less than (MAX_QP_WR * MAX_QP)
+																		// Since we use one single shared receive queue,
+																		// this number should be less than MAX_SRQ_WR
+
+	static const uint32_t MAX_NUMBER_OF_SGE_ELEMENTS = 1;				// Must be less than MAX_SGE
+
+	static const uint32_t MAX_NUMBER_OF_SEND_SGE_ELEMENTS = 8;			// Reduced to MAX_SGE of the device
+
+	static const uint32_t MAX_INLINE_DATA_SIZE = 256;					// Requested inline capacity, reduced to what the device grants
+
+	static const uint32_t MAX_COMPLETION_BATCH_SIZE = 64;				// Number of work completions drained per call to ibv_poll_cq
+
+	static const uint32_t COMPLETION_SPIN_TIME = 50;					// Microseconds to busy-poll before blocking on a completion channel
+
+	static const int32_t COMPLETION_EVENT_RECHECK_INTERVAL = 10;		// Milliseconds a blocked thread sleeps before checking again,
+																		// another thread may have consumed the event it was waiting for
+
+	static const uint32_t SUBMISSION_QUEUE_LENGTH = 4096;				// Operations a submission queue can hold, must be a power of two
+
+	static const uint32_t SUBMISSION_BATCH_SIZE = 32;					// Work requests chained into one ibv_post_send when draining a submission queue
+
+	static const uint64_t RECEIVE_BUFFER_SIZE = 4096;					// Default size of the buffers of a receive buffer pool
+
+	static const uint32_t QUEUE_PAIR_TABLE_SIZE = 256;					// Initial slots of the queue pair table of a completion queue group, must be a power of two
+
+public:
+
+	/**
+	 * System settings
+	 */
+
+	static const uint32_t PAGE_SIZE = 4096; 							// Memory regions will be page aligned by the Infinity library
+
+	static const uint32_t CACHE_LINE_SIZE = 64;							// Alignment of structures which are written by different threads
+
+	static const uint32_t MAX_CONNECTION_USER_DATA_SIZE = 1024;			// Size of the user data which can be transmitted when establishing a connection
+
+	static constexpr const char* DEFAULT_IB_DEVICE = "ib0";				// Default name of IB device
+
+public:
+
+	/**
+	 * Buffer pool settings
+	 */
+
+	static const uint64_t BUFFER_POOL_ARENA_SIZE = 64 * 1024 * 1024;	// Size of the memory regions registered by a buffer pool
+
+	static const uint64_t BUFFER_POOL_SLAB_SIZE = 256 * 1024;			// Memory carved from an arena when a size class runs empty
+
+	static const uint64_t BUFFER_POOL_MIN_BUFFER_SIZE = 64;				// Smallest size class, must be a power of two
+
+	static const uint32_t BUFFER_POOL_THREAD_CACHE_SIZE = 64;			// Buffers per size class kept in a thread-local cache
+
+public:
+
+	/**
+	 * Registration cache settings
+	 */
+
+	static const uint64_t REGISTRATION_CACHE_MAX_PINNED_SIZE = 1024UL * 1024 * 1024;	// Unused registrations are evicted beyond this many pinned bytes
+
+public:
+
+	/**
+	 * Request token pool settings
+	 */
+
+	static const uint32_t REQUEST_TOKEN_POOL_CHUNK_SIZE = 1024;			// Tokens allocated at once when a pool runs empty
+
+public:
+
+	/**
+	 * Flow control settings
+	 */
+
+	static const uint32_t FLOW_CONTROL_CREDITS = 64;					// Messages a peer may send before it has to wait for returned credits,
+																		// the receiver must keep this many buffers posted per connection
+
+public:
+
+	/**
+	 * Ring buffer channel settings
+	 */
+
+	static const uint32_t RING_BUFFER_CHANNEL_SIZE = 64 * 1024;			// Bytes of the ring a channel receives messages into, must be a power of two
+
+public:
+
+	/**
+	 * Runtime settings, initialized with the defaults above
+	 */
+	Configuration();
+
+	/**
+	 * Reduce settings which exceed the limits of the device or port
+	 */
+	void validate(ibv_device_attr *deviceAttributes, ibv_port_attr *portAttributes);
+
+public:
+
+	/**
+	 * Queue settings
+	 */
+
+	uint32_t sendCompletionQueueLength;
+	uint32_t receiveCompletionQueueLength;
+	uint32_t sharedReceiveQueueLength;
+
+	uint32_t sendQueueLength;											// Per queue pair
+	uint32_t receiveQueueLength;										// Per queue pair
+
+	uint32_t maxNumberOfSendSgeElements;
+	uint32_t maxNumberOfReceiveSgeElements;
+
+	uint32_t maxInlineDataSize;
+
+	uint32_t signalingInterval;											// Signal every n-th work request automatically (0 to disable)
+
+	bool useCompletionChannels;											// Attach completion channels to the completion queues to allow blocking waits
+	uint32_t completionSpinTime;										// Microseconds to busy-poll before blocking (if channels are used)
+
+	uint32_t receiveBufferPoolSize;										// Buffers of the receive pool of the context (0 to post buffers manually)
+	uint64_t receiveBufferSize;											// Size of each buffer of the receive pool
+	uint32_t receiveBufferLowWatermark;									// Refill the shared receive queue below this many posted buffers (0 for a quarter)
+
+	uint32_t notificationQueueLength;									// Zero-length receives kept posted per group for writes with immediate (0 to disable)
+	bool useNotificationQueue;											// Attach queue pairs to the notification queue, they then only receive writes with immediate
+
+public:
+
+	/**
+	 * Connection settings
+	 */
+
+	ibv_mtu pathMtu;
+
+	uint8_t timeout;													// Local ack timeout (4.096us * 2^timeout)
+	uint8_t retryCount;
+	uint8_t rnrRetryCount;
+	uint8_t minRnrTimer;
+
+	uint8_t maxOutstandingReadAtomicOperations;							// Outstanding RDMA reads and atomics per queue pair (0 for device limit)
+
+public:
+
+	/**
+	 * Placement settings
+	 */
+
+	bool allocateOnDeviceNumaNode;										// Place memory allocated by the library on the NUMA node of the device
+
+};
+
+} /* namespace core */
+} /* namespace infinity */
+
+#endif /* CORE_CONFIGURATION_H_ */
@@ -0,0 +1,108 @@
+/**
+ * Core - Progress Engine
+ *
+ * (c) 2018 Claude Barthels, ETH Zurich
+ * Contact: claudeb@inf.ethz.ch
+ *
+ */
+
+#ifndef CORE_PROGRESSENGINE_H_
+#define CORE_PROGRESSENGINE_H_
+
+#include <atomic>
+#include <mutex>
+#include <stdint.h>
+#include <thread>
+#include <vector>
+
+#include <infinity/core/CompletionQueueGroup.h>
+#include <infinity/core/Context.h>
+
+namespace infinity {
+namespace queues {
+class SubmissionQueue;
+}
+}
+
+namespace infinity {
+namespace core {
+
+/**
+ * Background thread which busy-polls the queues of a completion queue group, completes request tokens,
+ * hands received messages to a callback and drains submission queues
+ */
+class ProgressEngine {
+
+public:
+
+	/**
+	 * Called for every received message, returning true reposts the buffer to the shared receive queue
+	 * (or returns it to the receive buffer pool of the group)
+	 */
+	typedef bool (*ReceiveCallback)(receive_element_t *receiveElement, void *callbackContext);
+
+public:
+
+	/**
+	 * Drives the given group (or the default group of the context), the thread is pinned to the given core
+	 * or to the NUMA node of the device if core is negative
+	 */
+	ProgressEngine(Context *context, int32_t core = -1);
+	ProgressEngine(CompletionQueueGroup *completionQueueGroup, int32_t core = -1);
+
+	/**
+	 * Stops the engine if it is still running
+	 */
+	~ProgressEngine();
+
+public:
+
+	void start();
+	void stop();
+	bool isRunning();
+
+	/**
+	 * Receive completions are only consumed by the engine once a callback is set, must be called before start()
+	 */
+	void setReceiveCallback(ReceiveCallback receiveCallback, void *callbackContext);
+
+	/**
+	 * Submission queues drained on every iteration, can be changed while the engine is running
+	 * Removing a queue waits until the engine no longer drains it, the queue can be deleted afterwards
+	 */
+	void addSubmissionQueue(infinity::queues::SubmissionQueue *submissionQueue);
+	void removeSubmissionQueue(infinity::queues::SubmissionQueue *submissionQueue);
+
+	CompletionQueueGroup * getCompletionQueueGroup();
+
+protected:
+
+	void run();
+
+protected:
+
+	CompletionQueueGroup * const completionQueueGroup;
+	const int32_t core;
+
+	std::thread thread;
+	std::atomic<bool> running;
+
+	ReceiveCallback receiveCallback;
+	void *callbackContext;
+
+	std::mutex submissionQueuesLock;
+	std::vector<infinity::queues::SubmissionQueue *> submissionQueues;
+
+	/**
+	 * Raised on every change of the list, the engine acknowledges the version of the list it drains
+	 * (UINT64_MAX while no engine thread is running)
+	 */
+	std::atomic<uint64_t> submissionQueuesVersion;
+	std::atomic<uint64_t> acknowledgedSubmissionQueuesVersion;
+
+};
+
+} /* namespace core */
+} /* namespace infinity */
+
+#endif /* CORE_PROGRESSENGINE_H_ */
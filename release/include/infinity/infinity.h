@@ -0,0 +1,43 @@
+/**
+ * Infinity - A C++ RDMA library for InfiniBand
+ *
+ * (c) 2018 Claude Barthels, ETH Zurich
+ * Contact: claudeb@inf.ethz.ch
+ *
+ */
+
+#ifndef INFINITY_H_
+#define INFINITY_H_
+
+#include <infinity/core/CompletionQueueGroup.h>
+#include <infinity/core/Context.h>
+#include <infinity/core/Configuration.h>
+#include <infinity/core/ProgressEngine.h>
+#include <infinity/coroutines/Scheduler.h>
+#include <infinity/coroutines/Task.h>
+#include <infinity/memory/Atomic.h>
+#include <infinity/memory/Buffer.h>
+#include <infinity/memory/BufferPool.h>
+#include <infinity/memory/PageAllocator.h>
+#include <infinity/memory/PageType.h>
+#include <infinity/memory/ReceiveBufferPool.h>
+#include <infinity/memory/Region.h>
+#include <infinity/memory/RegionToken.h>
+#include <infinity/memory/RegionType.h>
+#include <infinity/memory/RegisteredMemory.h>
+#include <infinity/memory/RegistrationCache.h>
+#include <infinity/queues/FlowControlledQueuePair.h>
+#include <infinity/queues/QueuePair.h>
+#include <infinity/queues/QueuePairFactory.h>
+#include <infinity/queues/QueuePairTable.h>
+#include <infinity/queues/RingBufferChannel.h>
+#include <infinity/queues/SubmissionQueue.h>
+#include <infinity/queues/WorkRequestBatch.h>
+#include <infinity/requests/RequestGroup.h>
+#include <infinity/requests/RequestToken.h>
+#include <infinity/requests/RequestTokenPool.h>
+#include <infinity/utils/Address.h>
+#include <infinity/utils/Debug.h>
+#include <infinity/utils/Numa.h>
+
+#endif /* INFINITY_H_ */
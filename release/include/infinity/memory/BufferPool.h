@@ -0,0 +1,93 @@
+/*
+ * Memory - Buffer Pool
+ *
+ * (c) 2018 Claude Barthels, ETH Zurich
+ * Contact: claudeb@inf.ethz.ch
+ *
+ */
+
+#ifndef MEMORY_BUFFERPOOL_H_
+#define MEMORY_BUFFERPOOL_H_
+
+#include <stdint.h>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <unordered_map>
+
+#include <infinity/core/Configuration.h>
+#include <infinity/core/Context.h>
+#include <infinity/memory/Buffer.h>
+#include <infinity/memory/PageType.h>
+#include <infinity/memory/RegisteredMemory.h>
+
+namespace infinity {
+namespace memory {
+
+/**
+ * Hands out buffers from large pre-registered arenas, grouped into power-of-two size classes
+ */
+class BufferPool {
+
+public:
+
+	BufferPool(infinity::core::Context *context, uint64_t arenaSizeInBytes = infinity::core::Configuration::BUFFER_POOL_ARENA_SIZE,
+			PageType arenaPageType = SMALL_PAGES);
+	~BufferPool();
+
+public:
+
+	/**
+	 * Returns a buffer of the smallest size class which can hold sizeInBytes
+	 */
+	Buffer * allocate(uint64_t sizeInBytes);
+
+	/**
+	 * Returns a buffer obtained from allocate() to the pool
+	 */
+	void free(Buffer *buffer);
+
+	/**
+	 * Pool information
+	 */
+	uint64_t getSizeOfSizeClass(uint64_t sizeInBytes);
+	uint64_t getRegisteredSizeInBytes();
+
+protected:
+
+	static const uint32_t NUMBER_OF_SIZE_CLASSES = 40;
+
+	typedef struct {
+		std::vector<Buffer *> buffers[NUMBER_OF_SIZE_CLASSES];
+	} ThreadCache;
+
+	uint32_t getSizeClass(uint64_t sizeInBytes);
+	ThreadCache * getThreadCache();
+
+	void refillThreadCache(ThreadCache *threadCache, uint32_t sizeClass);
+	void flushThreadCache(ThreadCache *threadCache, uint32_t sizeClass);
+	void carveSlab(uint32_t sizeClass);
+
+protected:
+
+	infinity::core::Context * const context;
+	const uint64_t arenaSizeInBytes;
+	const PageType arenaPageType;
+	const uint64_t poolId;
+
+	std::mutex poolLock;
+
+	std::vector<RegisteredMemory *> arenas;
+	uint64_t arenaOffset;
+
+	std::vector<Buffer *> freeBuffers[NUMBER_OF_SIZE_CLASSES];
+	std::vector<Buffer *> allBuffers;
+
+	std::unordered_map<std::thread::id, ThreadCache *> threadCaches;
+
+};
+
+} /* namespace memory */
+} /* namespace infinity */
+
+#endif /* MEMORY_BUFFERPOOL_H_ */
@@ -0,0 +1,20 @@
+/*
+ * Memory - Page Type
+ *
+ * (c) 2018 Claude Barthels, ETH Zurich
+ * Contact: claudeb@inf.ethz.ch
+ *
+ */
+
+#ifndef MEMORY_PAGETYPE_H_
+#define MEMORY_PAGETYPE_H_
+
+namespace infinity {
+namespace memory {
+
+enum PageType {SMALL_PAGES, TRANSPARENT_HUGE_PAGES, HUGE_PAGES_2MB, HUGE_PAGES_1GB};
+
+} /* namespace memory */
+} /* namespace infinity */
+
+#endif /* MEMORY_PAGETYPE_H_ */
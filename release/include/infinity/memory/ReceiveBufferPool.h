@@ -0,0 +1,137 @@
+/*
+ * Memory - Receive Buffer Pool
+ *
+ * (c) 2018 Claude Barthels, ETH Zurich
+ * Contact: claudeb@inf.ethz.ch
+ *
+ */
+
+#ifndef MEMORY_RECEIVEBUFFERPOOL_H_
+#define MEMORY_RECEIVEBUFFERPOOL_H_
+
+#include <atomic>
+#include <stdint.h>
+
+#include <infinity/core/Configuration.h>
+#include <infinity/core/Context.h>
+#include <infinity/memory/Buffer.h>
+#include <infinity/memory/RegisteredMemory.h>
+
+namespace infinity {
+namespace core {
+class CompletionQueueGroup;
+}
+}
+
+namespace infinity {
+namespace memory {
+
+/**
+ * Fixed-size receive buffers carved from one registered arena which keep the shared receive queue of a group filled
+ * Buffers are reposted once the posted depth drops below the low watermark, either by the thread receiving messages
+ * or when the SRQ limit event is processed by Context::processAsyncEvents()
+ */
+class ReceiveBufferPool {
+
+	friend class infinity::core::CompletionQueueGroup;
+
+public:
+
+	/**
+	 * Posts min(numberOfBuffers, shared receive queue length) buffers right away and attaches the pool to the group
+	 * A low watermark of 0 refills once a quarter of the posted buffers is left
+	 * The group owns the pool from then on and deletes it together with its shared receive queue
+	 */
+	ReceiveBufferPool(infinity::core::CompletionQueueGroup *completionQueueGroup, uint32_t numberOfBuffers, uint64_t bufferSizeInBytes,
+			uint32_t lowWatermark = 0);
+
+protected:
+
+	/**
+	 * Called by the group once its shared receive queue was destroyed, posted receives cannot be withdrawn before
+	 */
+	~ReceiveBufferPool();
+
+public:
+
+	/**
+	 * Return a buffer handed out with a received message, can be called from any thread
+	 * Refills the shared receive queue right away if it is below the low watermark
+	 */
+	void release(Buffer *buffer);
+
+	/**
+	 * Post free buffers until the target depth is reached, returns the number of posted buffers
+	 * Concurrent calls return 0 immediately
+	 */
+	uint32_t replenish();
+
+	/**
+	 * Returns true if the buffer was carved from this pool
+	 */
+	inline bool ownsBuffer(Buffer *buffer) {
+		return buffer >= this->buffers && buffer < this->buffers + this->numberOfBuffers;
+	}
+
+public:
+
+	uint32_t getNumberOfBuffers();
+	uint32_t getNumberOfPostedBuffers();
+	uint32_t getTargetDepth();
+	uint32_t getLowWatermark();
+	uint64_t getBufferSizeInBytes();
+
+protected:
+
+	/**
+	 * Accounting done by the group while processing receive completions
+	 */
+	inline void onBufferConsumed() {
+		this->numberOfPostedBuffers.fetch_sub(1, std::memory_order_relaxed);
+	}
+
+	inline bool needsReplenishment() {
+		return this->numberOfPostedBuffers.load(std::memory_order_relaxed) < this->lowWatermark;
+	}
+
+	/**
+	 * Request an IBV_EVENT_SRQ_LIMIT_REACHED event once fewer than lowWatermark receives are posted (one-shot)
+	 */
+	void armLimitEvent();
+
+protected:
+
+	typedef struct entry {
+		struct entry *next;
+	} entry_t;
+
+	infinity::core::CompletionQueueGroup * const completionQueueGroup;
+	const uint32_t numberOfBuffers;
+	const uint64_t bufferSizeInBytes;
+	uint32_t targetDepth;
+	uint32_t lowWatermark;
+
+	RegisteredMemory *arena;
+	Buffer *buffers;
+	entry_t *entries;
+
+	/**
+	 * Free buffers only touched while holding the replenishing flag
+	 */
+	entry_t *freeEntries;
+	std::atomic_flag replenishing;
+
+	/**
+	 * Written by releasing threads and while processing completions
+	 */
+	char padding0[infinity::core::Configuration::CACHE_LINE_SIZE];
+	std::atomic<entry_t *> releasedEntries;
+	char padding1[infinity::core::Configuration::CACHE_LINE_SIZE];
+	std::atomic<uint32_t> numberOfPostedBuffers;
+
+};
+
+} /* namespace memory */
+} /* namespace infinity */
+
+#endif /* MEMORY_RECEIVEBUFFERPOOL_H_ */
@@ -0,0 +1,20 @@
+/*
+ * Memory - Region Type
+ *
+ * (c) 2018 Claude Barthels, ETH Zurich
+ * Contact: claudeb@inf.ethz.ch
+ *
+ */
+
+#ifndef MEMORY_REGIONTYPE_H_
+#define MEMORY_REGIONTYPE_H_
+
+namespace infinity {
+namespace memory {
+
+enum RegionType {BUFFER, ATOMIC, UNKNOWN};
+
+} /* namespace memory */
+} /* namespace infinity */
+
+#endif /* MEMORY_REGIONTYPE_H_ */
@@ -0,0 +1,57 @@
+/*
+ * Memory - Registered Memory
+ *
+ * (c) 2018 Claude Barthels, ETH Zurich
+ * Contact: claudeb@inf.ethz.ch
+ *
+ */
+
+#ifndef INFINITY_MEMORY_REGISTEREDMEMORY_H_
+#define INFINITY_MEMORY_REGISTEREDMEMORY_H_
+
+#include <infinity/core/Context.h>
+#include <infinity/memory/PageType.h>
+
+namespace infinity {
+namespace memory {
+
+class RegisteredMemory {
+
+public:
+
+	 RegisteredMemory(infinity::core::Context *context, uint64_t sizeInBytes);
+	 RegisteredMemory(infinity::core::Context *context, uint64_t sizeInBytes, PageType pageType);
+	 RegisteredMemory(infinity::core::Context *context, void *data, uint64_t sizeInBytes);
+	 ~RegisteredMemory();
+
+	 void * getData();
+
+	 uint64_t getSizeInBytes();
+
+	 ibv_mr * getRegion();
+
+	 /**
+	  * Page type backing the memory, may be smaller than the requested one if huge pages were not available
+	  */
+	 PageType getPageType();
+
+protected:
+
+	 infinity::core::Context* context;
+
+	 void *data;
+	 uint64_t sizeInBytes;
+
+	 ibv_mr *ibvMemoryRegion;
+
+protected:
+
+	 bool memoryAllocated;
+	 PageType pageType;
+
+};
+
+} /* namespace infinity */
+} /* namespace memory */
+
+#endif /* INFINITY_MEMORY_REGISTEREDMEMORY_H_ */
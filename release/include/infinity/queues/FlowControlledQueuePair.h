@@ -0,0 +1,120 @@
+/**
+ * Queues - Flow Controlled Queue Pair
+ *
+ * (c) 2018 Claude Barthels, ETH Zurich
+ * Contact: claudeb@inf.ethz.ch
+ *
+ */
+
+#ifndef QUEUES_FLOWCONTROLLEDQUEUEPAIR_H_
+#define QUEUES_FLOWCONTROLLEDQUEUEPAIR_H_
+
+#include <deque>
+#include <stdint.h>
+
+#include <infinity/core/CompletionQueueGroup.h>
+#include <infinity/core/Configuration.h>
+#include <infinity/memory/Buffer.h>
+#include <infinity/queues/QueuePair.h>
+#include <infinity/requests/RequestToken.h>
+
+namespace infinity {
+namespace queues {
+
+/**
+ * Credit-based flow control for sends on a connected queue pair, both sides must use it with the same number of credits
+ * Every send consumes a credit, sends without credits are queued locally instead of running into RNR retries
+ * Credits for consumed messages are returned in the immediate value of the next send, or in a separate zero-length
+ * update once half of them are pending
+ *
+ * Credits are a fixed share of the shared receive queue of the group, not a grant of individually posted buffers:
+ * the group must keep getNumberOfRequiredReceiveBuffers() (credits plus one per credit update which can be in flight) posted for every flow
+ * controlled queue pair. The constructor checks the sum against the receive buffer pool of the group if one is
+ * attached, or against the shared receive queue length otherwise.
+ */
+class FlowControlledQueuePair {
+
+public:
+
+	/**
+	 * Constructor (the queue pair remains owned by the caller)
+	 */
+	FlowControlledQueuePair(QueuePair *queuePair, uint32_t numberOfCredits = infinity::core::Configuration::FLOW_CONTROL_CREDITS);
+	~FlowControlledQueuePair();
+
+public:
+
+	/**
+	 * Send if a credit is available, returns false if the send was queued
+	 * Queued sends are posted once credits are returned, the buffer must not be modified until the request completed
+	 */
+	bool send(infinity::memory::Buffer *buffer, infinity::requests::RequestToken *requestToken = NULL);
+	bool send(infinity::memory::Buffer *buffer, uint32_t sizeInBytes, infinity::requests::RequestToken *requestToken = NULL);
+	bool send(infinity::memory::Buffer *buffer, uint64_t localOffset, uint32_t sizeInBytes, OperationFlags flags,
+			infinity::requests::RequestToken *requestToken = NULL);
+
+	/**
+	 * Account for a message received on this queue pair and post queued sends with the credits it carried
+	 * Call after its buffer was reposted, returns false for credit updates which carry no application data
+	 */
+	bool processReceive(infinity::core::receive_element_t *receiveElement);
+
+	/**
+	 * Post queued sends as long as credits are available, returns the number of posted sends
+	 */
+	uint32_t flush();
+
+public:
+
+	QueuePair * getQueuePair();
+	uint32_t getNumberOfCredits();
+	uint32_t getNumberOfRequiredReceiveBuffers();
+	uint32_t getNumberOfAvailableCredits();
+	uint32_t getNumberOfQueuedSends();
+
+	/**
+	 * Statistics
+	 */
+	uint64_t getNumberOfDeferredSends();
+	uint64_t getNumberOfCreditUpdates();
+
+protected:
+
+	/**
+	 * The immediate value carries returned credits, the flag marks messages without application data
+	 */
+	static const uint32_t CREDIT_UPDATE_FLAG = 0x80000000;
+
+	typedef struct {
+		infinity::memory::Buffer *buffer;
+		uint64_t localOffset;
+		uint32_t sizeInBytes;
+		OperationFlags flags;
+		infinity::requests::RequestToken *requestToken;
+	} queued_send_t;
+
+	void postSend(infinity::memory::Buffer *buffer, uint64_t localOffset, uint32_t sizeInBytes, OperationFlags flags,
+			infinity::requests::RequestToken *requestToken);
+	void sendCreditUpdate();
+
+protected:
+
+	QueuePair * const queuePair;
+	const uint32_t numberOfCredits;
+	const uint32_t creditReturnThreshold;
+
+	uint32_t availableCredits;
+	uint32_t creditsToReturn;
+	std::deque<queued_send_t> queuedSends;
+
+	infinity::memory::Buffer *creditUpdateBuffer;
+
+	uint64_t numberOfDeferredSends;
+	uint64_t numberOfCreditUpdates;
+
+};
+
+} /* namespace queues */
+} /* namespace infinity */
+
+#endif /* QUEUES_FLOWCONTROLLEDQUEUEPAIR_H_ */
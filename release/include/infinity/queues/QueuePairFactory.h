@@ -0,0 +1,83 @@
+/**
+ * Queues - Queue Pair Factory
+ *
+ * (c) 2018 Claude Barthels, ETH Zurich
+ * Contact: claudeb@inf.ethz.ch
+ *
+ */
+
+#ifndef QUEUES_QUEUEPAIRFACTORY_H_
+#define QUEUES_QUEUEPAIRFACTORY_H_
+
+#include <stdlib.h>
+#include <stdint.h>
+
+#include <infinity/core/Configuration.h>
+#include <infinity/core/Context.h>
+#include <infinity/queues/QueuePair.h>
+
+namespace infinity {
+namespace queues {
+
+class QueuePairFactory {
+public:
+
+	/**
+	 * Queue pairs are created with the given configuration and completion queue group or those of the context
+	 */
+	QueuePairFactory(infinity::core::Context *context, const infinity::core::Configuration *configuration = NULL,
+			infinity::core::CompletionQueueGroup *completionQueueGroup = NULL);
+	~QueuePairFactory();
+
+	/**
+	 * Bind to port for listening to incoming connections
+	 */
+	void bindToPort(uint16_t port);
+
+	/**
+	 * Accept incoming connection request (passive side)
+	 */
+	QueuePair * acceptIncomingConnection(void *userData = NULL, uint32_t userDataSizeInBytes = 0);
+
+	/**
+	 * Connect to remote machine (active side)
+	 */
+	QueuePair * connectToRemoteHost(const char* hostAddress, uint16_t port, void *userData = NULL, uint32_t userDataSizeInBytes = 0);
+
+	/**
+	 * Create loopback queue pair
+	 */
+	QueuePair * createLoopback(void *userData = NULL, uint32_t userDataSizeInBytes = 0);
+
+	/**
+	 * Limit the number of outstanding RDMA reads and atomics per queue pair (0 uses the device limits)
+	 */
+	void setMaxOutstandingReadAtomicOperations(uint8_t maxOutstandingReadAtomicOperations);
+
+	/**
+	 * Bind queue pairs created from now on to the given completion queue group (NULL for the default group of the context)
+	 */
+	void setCompletionQueueGroup(infinity::core::CompletionQueueGroup *completionQueueGroup);
+
+protected:
+
+	/**
+	 * Number of reads and atomics this side can issue (initiator) and accept (responder)
+	 */
+	uint8_t getLocalInitiatorReadAtomicLimit();
+	uint8_t getLocalResponderReadAtomicLimit();
+
+protected:
+
+	infinity::core::Context * context;
+	infinity::core::Configuration configuration;
+	infinity::core::CompletionQueueGroup *completionQueueGroup;
+
+	int32_t serverSocket;
+
+};
+
+} /* namespace queues */
+} /* namespace infinity */
+
+#endif /* QUEUES_QUEUEPAIRFACTORY_H_ */
@@ -0,0 +1,128 @@
+/**
+ * Queues - Ring Buffer Channel
+ *
+ * (c) 2018 Claude Barthels, ETH Zurich
+ * Contact: claudeb@inf.ethz.ch
+ *
+ */
+
+#ifndef QUEUES_RINGBUFFERCHANNEL_H_
+#define QUEUES_RINGBUFFERCHANNEL_H_
+
+#include <stdint.h>
+
+#include <infinity/core/Configuration.h>
+#include <infinity/core/Context.h>
+#include <infinity/memory/Buffer.h>
+#include <infinity/memory/RegionToken.h>
+#include <infinity/queues/QueuePair.h>
+#include <infinity/requests/RequestToken.h>
+
+namespace infinity {
+namespace queues {
+
+/**
+ * Bidirectional message channel which writes messages with RDMA writes into a ring of the remote side
+ * The receiver polls the ring for a header and a trailer, no receive work requests or completions are involved
+ * The consumed position is written back once a quarter of the ring was consumed, senders only see this much free space
+ * Relies on the device placing the bytes of a write in increasing address order, as most devices do
+ */
+class RingBufferChannel {
+
+public:
+
+	/**
+	 * Constructor (ring size must be a power of two)
+	 */
+	RingBufferChannel(infinity::core::Context *context, uint32_t ringSizeInBytes = infinity::core::Configuration::RING_BUFFER_CHANNEL_SIZE);
+	~RingBufferChannel();
+
+public:
+
+	/**
+	 * Region tokens of this side, pass them as user data when establishing the connection
+	 */
+	void * getConnectionData();
+	uint32_t getConnectionDataSize();
+
+	/**
+	 * Attach the channel to a queue pair established with the connection data of the remote channel
+	 * Messages are sent unsignaled, a signaling interval of a quarter of the send queue is set if the queue pair has none
+	 */
+	void connect(QueuePair *queuePair);
+
+public:
+
+	/**
+	 * Copy a message into the ring of the remote side, returns false if the ring has no room for it (or the write was not posted)
+	 */
+	bool send(const void *data, uint32_t sizeInBytes, infinity::requests::RequestToken *requestToken = NULL);
+
+	/**
+	 * Poll for the next message, the data points into the ring and remains valid until release() is called
+	 */
+	bool receive(void **data, uint32_t *sizeInBytes);
+
+	/**
+	 * Free the message returned by the last call to receive()
+	 */
+	void release();
+
+public:
+
+	uint32_t getRingSizeInBytes();
+	uint32_t getMaxMessageSize();
+	uint32_t getNumberOfFreeBytes();
+
+protected:
+
+	/**
+	 * Messages are 8-byte aligned records of a header, the data and a trailer which is set last
+	 */
+	typedef struct {
+		uint32_t sizeInBytes;
+		uint32_t type;
+	} header_t;
+
+	static const uint32_t RECORD_TYPE_MESSAGE = 1;
+	static const uint32_t RECORD_TYPE_WRAP = 2;
+	static const uint64_t TRAILER_VALID = 1;
+
+	inline uint32_t getRecordSize(uint32_t sizeInBytes) {
+		return sizeof(header_t) + ((sizeInBytes + 7) & ~7) + sizeof(uint64_t);
+	}
+
+	void writeBackHead();
+
+protected:
+
+	infinity::core::Context * const context;
+	const uint32_t ringSizeInBytes;
+	QueuePair *queuePair;
+
+	/**
+	 * Ring written by the remote side and words exchanging the consumed positions
+	 * (control buffer holds the remote head followed by the local head written back)
+	 */
+	infinity::memory::Buffer *receiveRing;
+	infinity::memory::Buffer *controlBuffer;
+	infinity::memory::RegionToken *connectionData;
+
+	/**
+	 * Copies of the sent messages at the same offsets as in the remote ring
+	 */
+	infinity::memory::Buffer *sendRing;
+	infinity::memory::RegionToken *remoteRingToken;
+	infinity::memory::RegionToken *remoteControlToken;
+
+	uint64_t tail;
+	uint64_t head;
+	uint64_t writtenBackHead;
+	uint32_t pendingRecordSize;
+
+};
+
+} /* namespace queues */
+} /* namespace infinity */
+
+#endif /* QUEUES_RINGBUFFERCHANNEL_H_ */
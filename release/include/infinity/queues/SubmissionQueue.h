@@ -0,0 +1,142 @@
+/**
+ * Queues - Submission Queue
+ *
+ * (c) 2018 Claude Barthels, ETH Zurich
+ * Contact: claudeb@inf.ethz.ch
+ *
+ */
+
+#ifndef QUEUES_SUBMISSIONQUEUE_H_
+#define QUEUES_SUBMISSIONQUEUE_H_
+
+#include <atomic>
+#include <stdint.h>
+
+#include <infinity/core/Configuration.h>
+#include <infinity/memory/Atomic.h>
+#include <infinity/memory/Buffer.h>
+#include <infinity/memory/RegionToken.h>
+#include <infinity/queues/QueuePair.h>
+#include <infinity/queues/WorkRequestBatch.h>
+#include <infinity/requests/RequestToken.h>
+
+namespace infinity {
+namespace queues {
+
+/**
+ * Lock-free multi-producer ring of operations for a queue pair, drained by a single thread into batched work request chains
+ */
+class SubmissionQueue {
+
+public:
+
+	/**
+	 * Constructor (length must be a power of two)
+	 */
+	SubmissionQueue(QueuePair *queuePair, uint32_t length = infinity::core::Configuration::SUBMISSION_QUEUE_LENGTH);
+
+	/**
+	 * Destructor
+	 */
+	~SubmissionQueue();
+
+public:
+
+	/**
+	 * Enqueue operations, safe to call from any thread, returns false if the queue is full
+	 * Request tokens are reset on submission, buffers and region tokens must stay valid until the queue was drained
+	 */
+
+	bool send(infinity::memory::Buffer *buffer, infinity::requests::RequestToken *requestToken = NULL);
+	bool send(infinity::memory::Buffer *buffer, uint64_t localOffset, uint32_t sizeInBytes, OperationFlags flags,
+			infinity::requests::RequestToken *requestToken = NULL);
+
+	bool write(infinity::memory::Buffer *buffer, infinity::memory::RegionToken *destination, infinity::requests::RequestToken *requestToken = NULL);
+	bool write(infinity::memory::Buffer *buffer, uint64_t localOffset, infinity::memory::RegionToken *destination, uint64_t remoteOffset, uint32_t sizeInBytes,
+			OperationFlags flags, infinity::requests::RequestToken *requestToken = NULL);
+
+	bool read(infinity::memory::Buffer *buffer, infinity::memory::RegionToken *source, infinity::requests::RequestToken *requestToken = NULL);
+	bool read(infinity::memory::Buffer *buffer, uint64_t localOffset, infinity::memory::RegionToken *source, uint64_t remoteOffset, uint32_t sizeInBytes,
+			OperationFlags flags, infinity::requests::RequestToken *requestToken = NULL);
+
+	bool sendWithImmediate(infinity::memory::Buffer *buffer, uint64_t localOffset, uint32_t sizeInBytes, uint32_t immediateValue,
+			OperationFlags flags, infinity::requests::RequestToken *requestToken = NULL);
+
+	bool writeWithImmediate(infinity::memory::Buffer *buffer, uint64_t localOffset, infinity::memory::RegionToken *destination, uint64_t remoteOffset,
+			uint32_t sizeInBytes, uint32_t immediateValue, OperationFlags flags, infinity::requests::RequestToken *requestToken = NULL);
+
+	bool compareAndSwap(infinity::memory::RegionToken *destination, infinity::memory::Atomic *previousValue, uint64_t compare, uint64_t swap,
+			OperationFlags flags, infinity::requests::RequestToken *requestToken = NULL);
+	bool fetchAndAdd(infinity::memory::RegionToken *destination, infinity::memory::Atomic *previousValue, uint64_t add,
+			OperationFlags flags, infinity::requests::RequestToken *requestToken = NULL);
+
+public:
+
+	/**
+	 * Post queued operations while the send queue has room, returns the number of posted work requests
+	 * Operations which do not fit are kept for the next call, only one thread drains at a time (concurrent calls return 0 immediately)
+	 */
+	uint32_t drain();
+
+	/**
+	 * Returns true if the draining thread took every enqueued operation (see hasUnpostedWorkRequests for operations it could not post yet)
+	 */
+	bool isEmpty();
+
+	/**
+	 * Returns true if the last drain left a batch which did not fit into the send queue (only meaningful on the draining thread)
+	 */
+	bool hasUnpostedWorkRequests();
+	QueuePair * getQueuePair();
+
+protected:
+
+	typedef enum {
+		SEND, SEND_WITH_IMMEDIATE, WRITE, WRITE_WITH_IMMEDIATE, READ, COMPARE_AND_SWAP, FETCH_AND_ADD
+	} OperationType;
+
+	typedef struct {
+		OperationType type;
+		infinity::memory::Buffer *buffer;
+		infinity::memory::Atomic *previousValue;
+		uint64_t localOffset;
+		infinity::memory::RegionToken *remoteRegion;
+		uint64_t remoteOffset;
+		uint32_t sizeInBytes;
+		uint32_t immediateValue;
+		uint64_t compareOrAdd;
+		uint64_t swap;
+		OperationFlags flags;
+		infinity::requests::RequestToken *requestToken;
+	} operation_t;
+
+	typedef struct {
+		std::atomic<uint64_t> sequence;
+		operation_t operation;
+	} slot_t;
+
+	bool enqueue(operation_t *operation);
+	bool dequeue(operation_t *operation);
+	void appendToBatch(operation_t *operation);
+
+protected:
+
+	QueuePair * const queuePair;
+	const uint32_t length;
+
+	slot_t *slots;
+	WorkRequestBatch *batch;
+
+	// Producer and consumer positions are kept on separate cache lines
+	char padding0[infinity::core::Configuration::CACHE_LINE_SIZE];
+	std::atomic<uint64_t> enqueuePosition;
+	char padding1[infinity::core::Configuration::CACHE_LINE_SIZE];
+	uint64_t dequeuePosition;
+	std::atomic_flag draining;
+
+};
+
+} /* namespace queues */
+} /* namespace infinity */
+
+#endif /* QUEUES_SUBMISSIONQUEUE_H_ */
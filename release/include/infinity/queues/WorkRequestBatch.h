@@ -0,0 +1,125 @@
+/**
+ * Queues - Work Request Batch
+ *
+ * (c) 2018 Claude Barthels, ETH Zurich
+ * Contact: claudeb@inf.ethz.ch
+ *
+ */
+
+#ifndef QUEUES_WORKREQUESTBATCH_H_
+#define QUEUES_WORKREQUESTBATCH_H_
+
+#include <stdint.h>
+#include <infiniband/verbs.h>
+
+#include <infinity/core/Context.h>
+#include <infinity/memory/Atomic.h>
+#include <infinity/memory/Buffer.h>
+#include <infinity/memory/RegionToken.h>
+#include <infinity/queues/QueuePair.h>
+#include <infinity/requests/RequestToken.h>
+
+namespace infinity {
+namespace queues {
+
+/**
+ * Stages operations in a preallocated chain of work requests which is posted with a single call to QueuePair::postBatch
+ */
+class WorkRequestBatch {
+
+	friend class infinity::queues::QueuePair;
+
+public:
+
+	/**
+	 * Constructor
+	 */
+	WorkRequestBatch(infinity::core::Context *context, uint32_t maxNumberOfWorkRequests);
+
+	/**
+	 * Destructor
+	 */
+	~WorkRequestBatch();
+
+public:
+
+	/**
+	 * Batch information
+	 */
+
+	uint32_t getNumberOfWorkRequests();
+	uint32_t getMaxNumberOfWorkRequests();
+	bool isEmpty();
+	bool isFull();
+
+	/**
+	 * Remove all staged operations
+	 */
+	void clear();
+
+public:
+
+	/**
+	 * Buffer operations
+	 */
+
+	void send(infinity::memory::Buffer *buffer, infinity::requests::RequestToken *requestToken = NULL);
+	void send(infinity::memory::Buffer *buffer, uint32_t sizeInBytes, infinity::requests::RequestToken *requestToken = NULL);
+	void send(infinity::memory::Buffer *buffer, uint64_t localOffset, uint32_t sizeInBytes, OperationFlags flags,
+			infinity::requests::RequestToken *requestToken = NULL);
+
+	void write(infinity::memory::Buffer *buffer, infinity::memory::RegionToken *destination, infinity::requests::RequestToken *requestToken = NULL);
+	void write(infinity::memory::Buffer *buffer, infinity::memory::RegionToken *destination, uint32_t sizeInBytes,
+			infinity::requests::RequestToken *requestToken = NULL);
+	void write(infinity::memory::Buffer *buffer, uint64_t localOffset, infinity::memory::RegionToken *destination, uint64_t remoteOffset, uint32_t sizeInBytes,
+			OperationFlags flags, infinity::requests::RequestToken *requestToken = NULL);
+
+	void read(infinity::memory::Buffer *buffer, infinity::memory::RegionToken *source, infinity::requests::RequestToken *requestToken = NULL);
+	void read(infinity::memory::Buffer *buffer, infinity::memory::RegionToken *source, uint32_t sizeInBytes, infinity::requests::RequestToken *requestToken =
+	NULL);
+	void read(infinity::memory::Buffer *buffer, uint64_t localOffset, infinity::memory::RegionToken *source, uint64_t remoteOffset, uint32_t sizeInBytes,
+			OperationFlags flags, infinity::requests::RequestToken *requestToken = NULL);
+
+	void sendWithImmediate(infinity::memory::Buffer *buffer, uint64_t localOffset, uint32_t sizeInBytes, uint32_t immediateValue,
+			OperationFlags flags, infinity::requests::RequestToken *requestToken = NULL);
+
+	void writeWithImmediate(infinity::memory::Buffer *buffer, uint64_t localOffset, infinity::memory::RegionToken *destination, uint64_t remoteOffset,
+			uint32_t sizeInBytes, uint32_t immediateValue, OperationFlags flags, infinity::requests::RequestToken *requestToken = NULL);
+
+public:
+
+	/**
+	 * Atomic value operations
+	 */
+
+	void compareAndSwap(infinity::memory::RegionToken *destination, uint64_t compare, uint64_t swap, infinity::requests::RequestToken *requestToken = NULL);
+	void compareAndSwap(infinity::memory::RegionToken *destination, infinity::memory::Atomic *previousValue, uint64_t compare, uint64_t swap,
+			OperationFlags flags, infinity::requests::RequestToken *requestToken = NULL);
+	void fetchAndAdd(infinity::memory::RegionToken *destination, uint64_t add, infinity::requests::RequestToken *requestToken = NULL);
+	void fetchAndAdd(infinity::memory::RegionToken *destination, infinity::memory::Atomic *previousValue, uint64_t add,
+			OperationFlags flags, infinity::requests::RequestToken *requestToken = NULL);
+
+protected:
+
+	/**
+	 * Append an empty work request with a single scatter-gather element to the chain
+	 */
+	ibv_send_wr * appendWorkRequest(infinity::memory::Region *region, uint64_t localOffset, uint32_t sizeInBytes, OperationFlags flags,
+			infinity::requests::RequestToken *requestToken);
+
+protected:
+
+	infinity::core::Context * const context;
+
+	ibv_send_wr *workRequests;
+	ibv_sge *sgElements;
+
+	uint32_t numberOfWorkRequests;
+	const uint32_t maxNumberOfWorkRequests;
+
+};
+
+} /* namespace queues */
+} /* namespace infinity */
+
+#endif /* QUEUES_WORKREQUESTBATCH_H_ */
@@ -0,0 +1,92 @@
+/**
+ * Requests - Request Token Pool
+ *
+ * (c) 2018 Claude Barthels, ETH Zurich
+ * Contact: claudeb@inf.ethz.ch
+ *
+ */
+
+#ifndef REQUESTS_REQUESTTOKENPOOL_H_
+#define REQUESTS_REQUESTTOKENPOOL_H_
+
+#include <atomic>
+#include <stdint.h>
+#include <vector>
+
+#include <infinity/core/Configuration.h>
+#include <infinity/core/Context.h>
+#include <infinity/requests/RequestToken.h>
+
+namespace infinity {
+namespace requests {
+
+/**
+ * Cache-line aligned request tokens, acquired and released in O(1) by the thread owning the pool
+ * Tokens returned on completion may be handed back by any thread (e.g. a progress engine)
+ */
+class RequestTokenPool {
+
+	friend class infinity::requests::RequestToken;
+
+public:
+
+	RequestTokenPool(infinity::core::Context *context, uint32_t tokensPerChunk = infinity::core::Configuration::REQUEST_TOKEN_POOL_CHUNK_SIZE);
+
+	/**
+	 * All tokens are destroyed, none of them may still be in use
+	 */
+	~RequestTokenPool();
+
+public:
+
+	/**
+	 * Returns a reset token without completion callback, the pool grows by a chunk if it runs empty
+	 * If releaseOnCompletion is set, the token returns to the pool after its completion (and callback) was processed
+	 * and must not be touched by the caller afterwards
+	 */
+	RequestToken * acquire(bool releaseOnCompletion = false);
+
+	/**
+	 * Return tokens to the pool, must be called by the owning thread
+	 */
+	void release(RequestToken *requestToken);
+	void release(RequestToken **requestTokens, uint32_t numberOfTokens);
+
+public:
+
+	uint64_t getNumberOfTokens();
+
+protected:
+
+	void allocateChunk();
+
+	/**
+	 * Lock-free push onto the list of tokens returned by other threads
+	 */
+	void returnCompletedToken(RequestToken *requestToken);
+
+protected:
+
+	infinity::core::Context * const context;
+	const uint32_t tokensPerChunk;
+
+	std::vector<RequestToken *> chunks;
+
+	/**
+	 * Owner-local free list
+	 */
+	RequestToken *freeTokens;
+	uint64_t numberOfTokens;
+
+	/**
+	 * Written by completing threads, taken as a whole by the owner when the local list runs empty
+	 */
+	char padding[infinity::core::Configuration::CACHE_LINE_SIZE];
+	std::atomic<RequestToken *> returnedTokens;
+
+};
+
+} /* namespace requests */
+} /* namespace infinity */
+
+#endif /* REQUESTS_REQUESTTOKENPOOL_H_ */
@@ -0,0 +1,48 @@
+/**
+ * Utils - NUMA
+ *
+ * (c) 2018 Claude Barthels, ETH Zurich
+ * Contact: claudeb@inf.ethz.ch
+ *
+ */
+
+#ifndef UTILS_NUMA_H_
+#define UTILS_NUMA_H_
+
+#include <stdint.h>
+#include <infiniband/verbs.h>
+
+namespace infinity {
+namespace utils {
+
+class Numa {
+
+public:
+
+	/**
+	 * Returns the NUMA node the device is attached to, -1 if unknown
+	 */
+	static int32_t getNumaNodeOfDevice(ibv_device *device);
+
+	/**
+	 * Returns the NUMA node the calling thread is currently running on, -1 if unknown
+	 */
+	static int32_t getCurrentNumaNode();
+
+	/**
+	 * Prefer the given node for the pages of a memory range, must be called before the memory is touched
+	 */
+	static bool bindMemoryToNode(void *data, uint64_t sizeInBytes, int32_t numaNode);
+
+	/**
+	 * Restrict the calling thread to the cores of a NUMA node or to a single core
+	 */
+	static bool pinThreadToNode(int32_t numaNode);
+	static bool pinThreadToCore(uint32_t core);
+
+};
+
+} /* namespace utils */
+} /* namespace infinity */
+
+#endif /* UTILS_NUMA_H_ */
@@ -0,0 +1,133 @@
+/**
+ * Examples - Coroutine Reads
+ *
+ * (c) 2018 Claude Barthels, ETH Zurich
+ * Contact: claudeb@inf.ethz.ch
+ *
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <cassert>
+
+#include <infinity/core/Context.h>
+#include <infinity/coroutines/Scheduler.h>
+#include <infinity/coroutines/Task.h>
+#include <infinity/queues/QueuePairFactory.h>
+#include <infinity/queues/QueuePair.h>
+#include <infinity/memory/Buffer.h>
+#include <infinity/memory/RegionToken.h>
+
+#define PORT_NUMBER 8011
+#define SERVER_IP "192.0.0.1"
+#define NUMBER_OF_SLOTS 4096
+#define NUMBER_OF_TASKS 256
+#define CHAIN_LENGTH 16
+
+// Follows a chain of remote slot indices, every read depends on the result of the previous one
+infinity::coroutines::Task followChain(infinity::coroutines::Scheduler *scheduler, infinity::queues::QueuePair *qp,
+		infinity::memory::RegionToken *remoteBufferToken, uint64_t startSlot, uint64_t *result) {
+
+	infinity::memory::Buffer *buffer = new infinity::memory::Buffer(scheduler->getContext(), sizeof(uint64_t));
+	infinity::queues::OperationFlags flags;
+
+	uint64_t slot = startSlot;
+	for (uint32_t i = 0; i < CHAIN_LENGTH; ++i) {
+		bool success = co_await scheduler->read(qp, buffer, 0, remoteBufferToken, slot * sizeof(uint64_t), sizeof(uint64_t), flags);
+		assert(success);
+		slot = *reinterpret_cast<uint64_t *>(buffer->getData());
+	}
+
+	*result = slot;
+	delete buffer;
+
+}
+
+// Usage: ./progam -s for server and ./program for client component
+int main(int argc, char **argv) {
+
+	bool isServer = false;
+
+	while (argc > 1) {
+		if (argv[1][0] == '-') {
+			switch (argv[1][1]) {
+
+				case 's': {
+					isServer = true;
+					break;
+				}
+
+			}
+		}
+		++argv;
+		--argc;
+	}
+
+	infinity::core::Context *context = new infinity::core::Context();
+	infinity::queues::QueuePairFactory *qpFactory = new infinity::queues::QueuePairFactory(context);
+	infinity::queues::QueuePair *qp;
+
+	if (isServer) {
+
+		printf("Creating slots to read from\n");
+		infinity::memory::Buffer *slots = new infinity::memory::Buffer(context, NUMBER_OF_SLOTS * sizeof(uint64_t));
+		uint64_t *data = reinterpret_cast<uint64_t *>(slots->getData());
+		for (uint64_t i = 0; i < NUMBER_OF_SLOTS; ++i) {
+			data[i] = (i * 7 + 1) % NUMBER_OF_SLOTS;
+		}
+		infinity::memory::RegionToken *slotsToken = slots->createRegionToken();
+
+		infinity::memory::Buffer *bufferToReceive = new infinity::memory::Buffer(context, sizeof(uint64_t));
+		context->postReceiveBuffer(bufferToReceive);
+
+		printf("Setting up connection (blocking)\n");
+		qpFactory->bindToPort(PORT_NUMBER);
+		qp = qpFactory->acceptIncomingConnection(slotsToken, sizeof(infinity::memory::RegionToken));
+
+		printf("Waiting for client to finish (blocking)\n");
+		infinity::core::receive_element_t receiveElement;
+		while (!context->receive(&receiveElement));
+
+		delete slotsToken;
+		delete slots;
+		delete bufferToReceive;
+
+	} else {
+
+		printf("Connecting to remote node\n");
+		qp = qpFactory->connectToRemoteHost(SERVER_IP, PORT_NUMBER);
+		infinity::memory::RegionToken *remoteBufferToken = (infinity::memory::RegionToken *) qp->getUserData();
+
+		printf("Following %d chains of %d dependent reads\n", NUMBER_OF_TASKS, CHAIN_LENGTH);
+		infinity::coroutines::Scheduler scheduler(context);
+		uint64_t results[NUMBER_OF_TASKS];
+		for (uint64_t i = 0; i < NUMBER_OF_TASKS; ++i) {
+			scheduler.spawn(followChain(&scheduler, qp, remoteBufferToken, i, &results[i]));
+		}
+		scheduler.run();
+
+		for (uint64_t i = 0; i < NUMBER_OF_TASKS; ++i) {
+			uint64_t expected = i;
+			for (uint32_t j = 0; j < CHAIN_LENGTH; ++j) {
+				expected = (expected * 7 + 1) % NUMBER_OF_SLOTS;
+			}
+			assert(results[i] == expected);
+		}
+		printf("All chains resolved\n");
+
+		infinity::memory::Buffer *buffer = new infinity::memory::Buffer(context, sizeof(uint64_t));
+		infinity::requests::RequestToken requestToken(context);
+		qp->send(buffer, &requestToken);
+		requestToken.waitUntilCompleted();
+		delete buffer;
+
+	}
+
+	delete qp;
+	delete qpFactory;
+	delete context;
+
+	return 0;
+
+}
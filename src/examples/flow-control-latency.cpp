@@ -0,0 +1,218 @@
+/**
+ * Examples - Flow Control Latency
+ *
+ * (c) 2018 Claude Barthels, ETH Zurich
+ * Contact: claudeb@inf.ethz.ch
+ *
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <algorithm>
+
+#include <infinity/core/Context.h>
+#include <infinity/queues/FlowControlledQueuePair.h>
+#include <infinity/queues/QueuePairFactory.h>
+#include <infinity/queues/QueuePair.h>
+#include <infinity/memory/Buffer.h>
+#include <infinity/requests/RequestToken.h>
+
+#define PORT_NUMBER 8011
+#define SERVER_IP "192.0.0.1"
+#define CREDITS 32
+#define SPARE_BUFFERS 4
+#define OUTSTANDING_REQUESTS 256
+#define MESSAGE_SIZE 64
+#define OPERATIONS_COUNT 65536
+#define SERVICE_TIME_NS 2000
+#define SIGNALING_INTERVAL 16
+
+uint64_t getTimeInNanoseconds();
+
+// Usage: ./progam -s for server and ./program for client component, add -f on both sides to enable credit-based flow control
+// The client keeps more requests in flight than the server has receive buffers, without flow control the excess runs into RNR retries
+int main(int argc, char **argv) {
+
+	bool isServer = false;
+	bool useFlowControl = false;
+
+	while (argc > 1) {
+		if (argv[1][0] == '-') {
+			switch (argv[1][1]) {
+
+			case 's': {
+				isServer = true;
+				break;
+			}
+
+			case 'f': {
+				useFlowControl = true;
+				break;
+			}
+
+			}
+		}
+		++argv;
+		--argc;
+	}
+
+	infinity::core::Context *context = new infinity::core::Context();
+	infinity::queues::QueuePairFactory *qpFactory = new infinity::queues::QueuePairFactory(context);
+	infinity::queues::QueuePair *qp;
+	infinity::queues::FlowControlledQueuePair *fcqp = NULL;
+
+	// Credits cover all receive buffers but a few spare ones for credit updates
+	uint32_t numberOfReceiveBuffers = isServer ? CREDITS + SPARE_BUFFERS : OUTSTANDING_REQUESTS + SPARE_BUFFERS;
+	infinity::memory::Buffer **receiveBuffers = new infinity::memory::Buffer *[numberOfReceiveBuffers];
+	for (uint32_t i = 0; i < numberOfReceiveBuffers; ++i) {
+		receiveBuffers[i] = new infinity::memory::Buffer(context, MESSAGE_SIZE);
+	}
+	context->postReceiveBuffers(receiveBuffers, numberOfReceiveBuffers);
+
+	if (isServer) {
+
+		printf("Waiting for incoming connection\n");
+		qpFactory->bindToPort(PORT_NUMBER);
+		qp = qpFactory->acceptIncomingConnection();
+		qp->setSignalingInterval(SIGNALING_INTERVAL);
+		if (useFlowControl) {
+			fcqp = new infinity::queues::FlowControlledQueuePair(qp, CREDITS);
+		}
+
+		infinity::memory::Buffer *replyBuffer = new infinity::memory::Buffer(context, OUTSTANDING_REQUESTS * MESSAGE_SIZE);
+
+		printf("Answering requests (%u ns service time)\n", SERVICE_TIME_NS);
+		uint32_t numberOfAnsweredRequests = 0;
+		while (numberOfAnsweredRequests < OPERATIONS_COUNT) {
+
+			infinity::core::receive_element_t receiveElement;
+			if (!context->receive(&receiveElement)) {
+				continue;
+			}
+
+			uint32_t requestId;
+			memcpy(&requestId, receiveElement.buffer->getData(), sizeof(uint32_t));
+			context->postReceiveBuffer(receiveElement.buffer);
+			if (useFlowControl && !fcqp->processReceive(&receiveElement)) {
+				continue;
+			}
+
+			uint64_t serviceEndTime = getTimeInNanoseconds() + SERVICE_TIME_NS;
+			while (getTimeInNanoseconds() < serviceEndTime);
+
+			uint64_t replyOffset = (numberOfAnsweredRequests % OUTSTANDING_REQUESTS) * MESSAGE_SIZE;
+			memcpy(reinterpret_cast<char *>(replyBuffer->getData()) + replyOffset, &requestId, sizeof(uint32_t));
+			if (useFlowControl) {
+				fcqp->send(replyBuffer, replyOffset, MESSAGE_SIZE, infinity::queues::OperationFlags());
+			} else {
+				qp->send(replyBuffer, replyOffset, MESSAGE_SIZE, infinity::queues::OperationFlags());
+			}
+			++numberOfAnsweredRequests;
+
+		}
+
+		printf("All requests answered\n");
+		if (useFlowControl) {
+			printf("Deferred %lu replies, sent %lu credit updates\n", fcqp->getNumberOfDeferredSends(), fcqp->getNumberOfCreditUpdates());
+		}
+
+		delete replyBuffer;
+
+	} else {
+
+		printf("Connecting to remote node\n");
+		qp = qpFactory->connectToRemoteHost(SERVER_IP, PORT_NUMBER);
+		qp->setSignalingInterval(SIGNALING_INTERVAL);
+		if (useFlowControl) {
+			fcqp = new infinity::queues::FlowControlledQueuePair(qp, CREDITS);
+		}
+
+		infinity::memory::Buffer *requestBuffer = new infinity::memory::Buffer(context, OUTSTANDING_REQUESTS * MESSAGE_SIZE);
+		uint64_t *sendTimes = new uint64_t[OPERATIONS_COUNT];
+		uint64_t *latencies = new uint64_t[OPERATIONS_COUNT];
+
+		printf("Sending %u requests with %u in flight (flow control %s)\n", OPERATIONS_COUNT, OUTSTANDING_REQUESTS, useFlowControl ? "on" : "off");
+		uint32_t numberOfSentRequests = 0;
+		uint32_t numberOfCompletedRequests = 0;
+		uint64_t startTime = getTimeInNanoseconds();
+
+		while (numberOfCompletedRequests < OPERATIONS_COUNT) {
+
+			// Latencies include the time a request spends queued behind missing credits
+			while (numberOfSentRequests < OPERATIONS_COUNT && numberOfSentRequests - numberOfCompletedRequests < OUTSTANDING_REQUESTS) {
+				uint64_t requestOffset = (numberOfSentRequests % OUTSTANDING_REQUESTS) * MESSAGE_SIZE;
+				memcpy(reinterpret_cast<char *>(requestBuffer->getData()) + requestOffset, &numberOfSentRequests, sizeof(uint32_t));
+				sendTimes[numberOfSentRequests] = getTimeInNanoseconds();
+				if (useFlowControl) {
+					fcqp->send(requestBuffer, requestOffset, MESSAGE_SIZE, infinity::queues::OperationFlags());
+				} else {
+					qp->send(requestBuffer, requestOffset, MESSAGE_SIZE, infinity::queues::OperationFlags());
+				}
+				++numberOfSentRequests;
+			}
+
+			infinity::core::receive_element_t receiveElement;
+			if (!context->receive(&receiveElement)) {
+				continue;
+			}
+
+			uint32_t requestId;
+			memcpy(&requestId, receiveElement.buffer->getData(), sizeof(uint32_t));
+			context->postReceiveBuffer(receiveElement.buffer);
+			if (useFlowControl && !fcqp->processReceive(&receiveElement)) {
+				continue;
+			}
+
+			latencies[numberOfCompletedRequests++] = getTimeInNanoseconds() - sendTimes[requestId];
+
+		}
+
+		uint64_t totalTime = getTimeInNanoseconds() - startTime;
+		std::sort(latencies, latencies + OPERATIONS_COUNT);
+
+		printf("Throughput\t%.3f req/sec\n", ((double) OPERATIONS_COUNT) * 1000000000L / totalTime);
+		printf("Latency p50\t%.3f us\n", latencies[OPERATIONS_COUNT / 2] / 1000.0);
+		printf("Latency p99\t%.3f us\n", latencies[(OPERATIONS_COUNT * 99) / 100] / 1000.0);
+		printf("Latency max\t%.3f us\n", latencies[OPERATIONS_COUNT - 1] / 1000.0);
+		if (useFlowControl) {
+			printf("Deferred %lu requests, sent %lu credit updates\n", fcqp->getNumberOfDeferredSends(), fcqp->getNumberOfCreditUpdates());
+		}
+
+		delete[] latencies;
+		delete[] sendTimes;
+		delete requestBuffer;
+
+	}
+
+	// Queued sends must be posted before the queue pair goes away
+	if (useFlowControl) {
+		while (fcqp->getNumberOfQueuedSends() > 0) {
+			infinity::core::receive_element_t receiveElement;
+			if (context->receive(&receiveElement)) {
+				context->postReceiveBuffer(receiveElement.buffer);
+				fcqp->processReceive(&receiveElement);
+			}
+		}
+		delete fcqp;
+	}
+
+	for (uint32_t i = 0; i < numberOfReceiveBuffers; ++i) {
+		delete receiveBuffers[i];
+	}
+	delete[] receiveBuffers;
+
+	delete qp;
+	delete qpFactory;
+	delete context;
+
+	return 0;
+
+}
+
+uint64_t getTimeInNanoseconds() {
+	struct timespec time;
+	clock_gettime(CLOCK_MONOTONIC, &time);
+	return time.tv_sec * 1000000000L + time.tv_nsec;
+}
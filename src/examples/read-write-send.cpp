@@ -16,6 +16,7 @@
 #include <infinity/queues/QueuePair.h>
 #include <infinity/memory/Buffer.h>
 #include <infinity/memory/RegionToken.h>
+#include <infinity/requests/RequestGroup.h>
 #include <infinity/requests/RequestToken.h>
 
 #define PORT_NUMBER 8011
@@ -87,6 +88,22 @@ int main(int argc, char **argv) {
 		qp->write(buffer1Sided, remoteBufferToken, &requestToken);
 		requestToken.waitUntilCompleted();
 
+		printf("Reading content through a request group\n");
+		infinity::requests::RequestGroup *requestGroup = new infinity::requests::RequestGroup(context, 1);
+		requestGroup->add(&requestToken);
+		qp->read(buffer1Sided, remoteBufferToken, &requestToken);
+		requestGroup->waitAll();
+		assert(requestGroup->wasSuccessful());
+		requestGroup->reset();
+
+		printf("Reusing the token after the group was reset and deleted\n");
+		qp->read(buffer1Sided, remoteBufferToken, &requestToken);
+		requestToken.waitUntilCompleted();
+		assert(requestGroup->getNumberOfCompletedRequests() == 0);
+		delete requestGroup;
+		qp->read(buffer1Sided, remoteBufferToken, &requestToken);
+		requestToken.waitUntilCompleted();
+
 		printf("Sending message to remote host\n");
 		qp->send(buffer2Sided, &requestToken);
 		requestToken.waitUntilCompleted();
@@ -16,6 +16,7 @@
 #include <infinity/core/Context.h>
 #include <infinity/queues/QueuePairFactory.h>
 #include <infinity/queues/QueuePair.h>
+#include <infinity/queues/WorkRequestBatch.h>
 #include <infinity/memory/Buffer.h>
 #include <infinity/memory/RegionToken.h>
 #include <infinity/requests/RequestToken.h>
@@ -25,13 +26,15 @@
 #define BUFFER_COUNT 128
 #define MAX_BUFFER_SIZE 4096
 #define OPERATIONS_COUNT 1024
+#define BATCH_SIZE 16
 
 uint64_t timeDiff(struct timeval stop, struct timeval start);
 
-// Usage: ./progam -s for server and ./program for client component
+// Usage: ./progam -s for server and ./program for client component, add -b on the client to post sends in batches
 int main(int argc, char **argv) {
 
 	bool isServer = false;
+	bool useBatching = false;
 
 	while (argc > 1) {
 		if (argv[1][0] == '-') {
@@ -42,6 +45,11 @@ int main(int argc, char **argv) {
 				break;
 			}
 
+			case 'b': {
+				useBatching = true;
+				break;
+			}
+
 			}
 		}
 		++argv;
@@ -58,8 +66,8 @@ int main(int argc, char **argv) {
 		infinity::memory::Buffer **receiveBuffers = new infinity::memory::Buffer *[BUFFER_COUNT];
 		for (uint32_t i = 0; i < BUFFER_COUNT; ++i) {
 			receiveBuffers[i] = new infinity::memory::Buffer(context, MAX_BUFFER_SIZE * sizeof(char));
-			context->postReceiveBuffer(receiveBuffers[i]);
 		}
+		context->postReceiveBuffers(receiveBuffers, BUFFER_COUNT);
 
 		printf("Waiting for incoming connection\n");
 		qpFactory->bindToPort(PORT_NUMBER);
@@ -70,6 +78,9 @@ int main(int argc, char **argv) {
 		while (!context->receive(&receiveElement));
 		context->postReceiveBuffer(receiveElement.buffer);
 
+		infinity::core::receive_element_t receiveElements[BATCH_SIZE];
+		infinity::memory::Buffer *receivedBuffers[BATCH_SIZE];
+
 		printf("Performing measurement\n");
 
 		uint32_t messageSize = 1;
@@ -82,9 +93,13 @@ int main(int argc, char **argv) {
 
 			uint32_t numberOfReceivedMessages = 0;
 			while (numberOfReceivedMessages < OPERATIONS_COUNT) {
-				while (!context->receive(&receiveElement));
-				++numberOfReceivedMessages;
-				context->postReceiveBuffer(receiveElement.buffer);
+				uint32_t maxNumberOfElements = (OPERATIONS_COUNT - numberOfReceivedMessages < BATCH_SIZE) ? OPERATIONS_COUNT - numberOfReceivedMessages : BATCH_SIZE;
+				uint32_t numberOfElements = context->receiveBatch(receiveElements, maxNumberOfElements);
+				for (uint32_t i = 0; i < numberOfElements; ++i) {
+					receivedBuffers[i] = receiveElements[i].buffer;
+				}
+				context->postReceiveBuffers(receivedBuffers, numberOfElements);
+				numberOfReceivedMessages += numberOfElements;
 			}
 
 			messageSize *= 2;
@@ -113,6 +128,7 @@ int main(int argc, char **argv) {
 		infinity::memory::Buffer *sendBuffer = new infinity::memory::Buffer(context, MAX_BUFFER_SIZE * sizeof(char));
 		infinity::memory::Buffer *receiveBuffer = new infinity::memory::Buffer(context, sizeof(char));
 		context->postReceiveBuffer(receiveBuffer);
+		infinity::queues::WorkRequestBatch *batch = new infinity::queues::WorkRequestBatch(context, BATCH_SIZE);
 
 		printf("Sending first message\n");
 		qp->send(sendBuffer, sizeof(char), context->defaultRequestToken);
@@ -130,18 +146,43 @@ int main(int argc, char **argv) {
 			struct timeval start;
 			gettimeofday(&start, NULL);
 
-			for(uint32_t i=0; i<OPERATIONS_COUNT; ++i) {
-				if(i %BUFFER_COUNT == 0 || i == OPERATIONS_COUNT) {
+			if (useBatching) {
+
+				for(uint32_t i=0; i<OPERATIONS_COUNT; ++i) {
+					if(i %BUFFER_COUNT == 0) {
+
+						infinity::requests::RequestToken requestToken(context);
+						batch->send(sendBuffer, messageSize, &requestToken);
+						qp->postBatch(batch);
+						requestToken.waitUntilCompleted();
 
-					infinity::requests::RequestToken requestToken(context);
-					qp->send(sendBuffer, messageSize, &requestToken);
-					requestToken.waitUntilCompleted();
+					} else {
 
-				} else {
+						batch->send(sendBuffer, messageSize, NULL);
+						if (batch->isFull()) {
+							qp->postBatch(batch);
+						}
 
-					qp->send(sendBuffer, messageSize, NULL);
+					}
+				}
+				qp->postBatch(batch);
+
+			} else {
+
+				for(uint32_t i=0; i<OPERATIONS_COUNT; ++i) {
+					if(i %BUFFER_COUNT == 0 || i == OPERATIONS_COUNT) {
+
+						infinity::requests::RequestToken requestToken(context);
+						qp->send(sendBuffer, messageSize, &requestToken);
+						requestToken.waitUntilCompleted();
 
+					} else {
+
+						qp->send(sendBuffer, messageSize, NULL);
+
+					}
 				}
+
 			}
 
 			struct timeval stop;
@@ -161,6 +202,7 @@ int main(int argc, char **argv) {
 		infinity::core::receive_element_t receiveElement;
 		while (!context->receive(&receiveElement));
 
+		delete batch;
 		delete receiveBuffer;
 		delete sendBuffer;
 	}
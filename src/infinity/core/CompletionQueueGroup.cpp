@@ -0,0 +1,584 @@
+/**
+ * Core - Completion Queue Group
+ *
+ * (c) 2018 Claude Barthels, ETH Zurich
+ * Contact: claudeb@inf.ethz.ch
+ *
+ */
+
+#include "CompletionQueueGroup.h"
+
+#include <fcntl.h>
+#include <poll.h>
+#include <string.h>
+#include <time.h>
+#include <limits>
+#include <thread>
+#include <arpa/inet.h>
+
+#include <infinity/core/Configuration.h>
+#include <infinity/queues/QueuePair.h>
+#include <infinity/memory/Buffer.h>
+#include <infinity/memory/ReceiveBufferPool.h>
+#include <infinity/requests/RequestToken.h>
+#include <infinity/utils/Debug.h>
+
+#define MIN(a,b) ((a) < (b) ? (a) : (b))
+
+namespace infinity {
+namespace core {
+
+static uint64_t getTimeInMicroseconds() {
+	timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return now.tv_sec * 1000000ull + now.tv_nsec / 1000;
+}
+
+static ibv_comp_channel * createCompletionChannel(ibv_context *ibvContext) {
+
+	ibv_comp_channel *completionChannel = ibv_create_comp_channel(ibvContext);
+	INFINITY_ASSERT(completionChannel != NULL, "[INFINITY][CORE][GROUP] Could not allocate completion channel.\n");
+
+	// Waiting is done with poll, reading the channel must never block
+	int flags = fcntl(completionChannel->fd, F_GETFL);
+	int returnValue = fcntl(completionChannel->fd, F_SETFL, flags | O_NONBLOCK);
+	INFINITY_ASSERT(returnValue == 0, "[INFINITY][CORE][GROUP] Could not make completion channel non-blocking.\n");
+
+	return completionChannel;
+
+}
+
+CompletionQueueGroup::CompletionQueueGroup(Context* context) :
+		context(context) {
+
+	const Configuration *configuration = context->getConfiguration();
+
+	this->progressEngineAttached.store(false);
+	this->progressEngineThread.store(std::thread::id());
+	this->numberOfReservedReceiveBuffers.store(0);
+	this->receiveBufferPool = NULL;
+
+	// Allocate completion channels
+	this->ibvSendCompletionChannel = NULL;
+	this->ibvReceiveCompletionChannel = NULL;
+	if (configuration->useCompletionChannels) {
+		this->ibvSendCompletionChannel = createCompletionChannel(context->getInfiniBandContext());
+		this->ibvReceiveCompletionChannel = createCompletionChannel(context->getInfiniBandContext());
+	}
+
+	// Allocate completion queues
+	this->ibvSendCompletionQueue = ibv_create_cq(context->getInfiniBandContext(), configuration->sendCompletionQueueLength, NULL,
+			this->ibvSendCompletionChannel, 0);
+	INFINITY_ASSERT(this->ibvSendCompletionQueue != NULL, "[INFINITY][CORE][GROUP] Could not allocate send completion queue.\n");
+	this->ibvReceiveCompletionQueue = ibv_create_cq(context->getInfiniBandContext(), configuration->receiveCompletionQueueLength, NULL,
+			this->ibvReceiveCompletionChannel, 0);
+	INFINITY_ASSERT(this->ibvReceiveCompletionQueue != NULL, "[INFINITY][CORE][GROUP] Could not allocate receive completion queue.\n");
+
+	// Allocate shared receive queue
+	ibv_srq_init_attr sia;
+	memset(&sia, 0, sizeof(ibv_srq_init_attr));
+	sia.srq_context = this;
+	sia.attr.max_wr = configuration->sharedReceiveQueueLength;
+	sia.attr.max_sge = configuration->maxNumberOfReceiveSgeElements;
+	this->ibvSharedReceiveQueue = ibv_create_srq(context->getProtectionDomain(), &sia);
+	INFINITY_ASSERT(this->ibvSharedReceiveQueue != NULL, "[INFINITY][CORE][GROUP] Could not allocate shared receive queue.\n");
+
+	// Allocate notification queue, its receives carry no scatter-gather elements
+	this->ibvNotificationQueue = NULL;
+	this->notificationQueueLength = configuration->notificationQueueLength;
+	this->consumedNotificationReceives = 0;
+	if (this->notificationQueueLength > 0) {
+		memset(&sia, 0, sizeof(ibv_srq_init_attr));
+		sia.srq_context = this;
+		sia.attr.max_wr = this->notificationQueueLength;
+		sia.attr.max_sge = 1;
+		this->ibvNotificationQueue = ibv_create_srq(context->getProtectionDomain(), &sia);
+		INFINITY_ASSERT(this->ibvNotificationQueue != NULL, "[INFINITY][CORE][GROUP] Could not allocate notification queue.\n");
+		postNotificationReceives(this->notificationQueueLength);
+	}
+
+}
+
+CompletionQueueGroup::~CompletionQueueGroup() {
+
+	// Destroy shared receive queues
+	int returnValue = ibv_destroy_srq(this->ibvSharedReceiveQueue);
+	INFINITY_ASSERT(returnValue == 0, "[INFINITY][CORE][GROUP] Could not delete shared receive queue\n");
+	if (this->ibvNotificationQueue != NULL) {
+		returnValue = ibv_destroy_srq(this->ibvNotificationQueue);
+		INFINITY_ASSERT(returnValue == 0, "[INFINITY][CORE][GROUP] Could not delete notification queue\n");
+	}
+
+	// Buffers of the pool may have been posted until now
+	delete this->receiveBufferPool;
+	this->receiveBufferPool = NULL;
+
+	// Destroy completion queues
+	returnValue = ibv_destroy_cq(this->ibvSendCompletionQueue);
+	INFINITY_ASSERT(returnValue == 0, "[INFINITY][CORE][GROUP] Could not delete send completion queue\n");
+	returnValue = ibv_destroy_cq(this->ibvReceiveCompletionQueue);
+	INFINITY_ASSERT(returnValue == 0, "[INFINITY][CORE][GROUP] Could not delete receive completion queue\n");
+
+	// Destroy completion channels
+	if (this->ibvSendCompletionChannel != NULL) {
+		returnValue = ibv_destroy_comp_channel(this->ibvSendCompletionChannel);
+		INFINITY_ASSERT(returnValue == 0, "[INFINITY][CORE][GROUP] Could not delete send completion channel\n");
+	}
+	if (this->ibvReceiveCompletionChannel != NULL) {
+		returnValue = ibv_destroy_comp_channel(this->ibvReceiveCompletionChannel);
+		INFINITY_ASSERT(returnValue == 0, "[INFINITY][CORE][GROUP] Could not delete receive completion channel\n");
+	}
+
+}
+
+void CompletionQueueGroup::postReceiveBuffer(infinity::memory::Buffer* buffer) {
+	postReceiveBuffers(&buffer, 1);
+}
+
+void CompletionQueueGroup::postReceiveBuffers(infinity::memory::Buffer** buffers, uint32_t numberOfBuffers) {
+
+	ibv_sge isge[Configuration::MAX_COMPLETION_BATCH_SIZE];
+	ibv_recv_wr wr[Configuration::MAX_COMPLETION_BATCH_SIZE];
+
+	for (uint32_t offset = 0; offset < numberOfBuffers; offset += Configuration::MAX_COMPLETION_BATCH_SIZE) {
+
+		uint32_t batchSize = MIN(numberOfBuffers - offset, Configuration::MAX_COMPLETION_BATCH_SIZE);
+
+		for (uint32_t i = 0; i < batchSize; ++i) {
+
+			infinity::memory::Buffer *buffer = buffers[offset + i];
+			INFINITY_ASSERT(buffer->getSizeInBytes() <= std::numeric_limits<uint32_t>::max(),
+					"[INFINITY][CORE][GROUP] Cannot post receive buffer which is larger than max(uint32_t).\n");
+
+			// Create scatter-getter
+			isge[i].addr = buffer->getAddress();
+			isge[i].length = static_cast<uint32_t>(buffer->getSizeInBytes());
+			isge[i].lkey = buffer->getLocalKey();
+
+			// Create work request
+			wr[i].wr_id = reinterpret_cast<uint64_t>(buffer);
+			wr[i].next = (i + 1 < batchSize) ? &(wr[i + 1]) : NULL;
+			wr[i].sg_list = &(isge[i]);
+			wr[i].num_sge = 1;
+
+		}
+
+		// Post chain to shared receive queue
+		ibv_recv_wr *badwr;
+		uint32_t returnValue = ibv_post_srq_recv(this->ibvSharedReceiveQueue, wr, &badwr);
+		INFINITY_ASSERT(returnValue == 0, "[INFINITY][CORE][GROUP] Cannot post buffer to receive queue.\n");
+
+	}
+
+}
+
+void CompletionQueueGroup::postNotificationReceives(uint32_t numberOfReceives) {
+
+	ibv_recv_wr wr[Configuration::MAX_COMPLETION_BATCH_SIZE];
+	memset(wr, 0, sizeof(wr));
+
+	for (uint32_t offset = 0; offset < numberOfReceives; offset += Configuration::MAX_COMPLETION_BATCH_SIZE) {
+
+		uint32_t batchSize = MIN(numberOfReceives - offset, Configuration::MAX_COMPLETION_BATCH_SIZE);
+
+		// A work request id of 0 marks notification receives
+		for (uint32_t i = 0; i < batchSize; ++i) {
+			wr[i].wr_id = 0;
+			wr[i].next = (i + 1 < batchSize) ? &(wr[i + 1]) : NULL;
+			wr[i].sg_list = NULL;
+			wr[i].num_sge = 0;
+		}
+
+		ibv_recv_wr *badwr;
+		uint32_t returnValue = ibv_post_srq_recv(this->ibvNotificationQueue, wr, &badwr);
+		INFINITY_ASSERT(returnValue == 0, "[INFINITY][CORE][GROUP] Cannot post to notification queue.\n");
+
+	}
+
+}
+
+void CompletionQueueGroup::replenishNotificationReceives() {
+
+	// Repost in batches, a quarter of the queue may be consumed before the sender can run dry
+	uint32_t threshold = MIN(Configuration::MAX_COMPLETION_BATCH_SIZE, (this->notificationQueueLength + 3) / 4);
+	if (this->consumedNotificationReceives > 0 && this->consumedNotificationReceives >= threshold) {
+		postNotificationReceives(this->consumedNotificationReceives);
+		this->consumedNotificationReceives = 0;
+	}
+
+}
+
+bool CompletionQueueGroup::hasNotificationQueue() {
+	return this->ibvNotificationQueue != NULL;
+}
+
+bool CompletionQueueGroup::receive(receive_element_t* receiveElement) {
+
+	ibv_wc wc;
+	if (ibv_poll_cq(this->ibvReceiveCompletionQueue, 1, &wc) > 0) {
+		infinity::memory::Buffer *consumedBuffer = processReceiveCompletion(&wc, &(receiveElement->buffer), &(receiveElement->bytesWritten),
+				&(receiveElement->immediateValue), &(receiveElement->immediateValueValid), &(receiveElement->queuePair), &(receiveElement->queuePairContext));
+		if (consumedBuffer != NULL) {
+			postReceiveBuffer(consumedBuffer);
+		}
+		replenishReceiveBuffers();
+		replenishNotificationReceives();
+		return true;
+	}
+
+	// Buffers released while none were posted produce no completion, so refill on empty polls as well
+	replenishReceiveBuffers();
+	return false;
+
+}
+
+bool CompletionQueueGroup::receive(infinity::memory::Buffer** buffer, uint32_t *bytesWritten, uint32_t *immediateValue, bool *immediateValueValid, infinity::queues::QueuePair **queuePair) {
+
+	ibv_wc wc;
+	if (ibv_poll_cq(this->ibvReceiveCompletionQueue, 1, &wc) > 0) {
+		infinity::memory::Buffer *consumedBuffer = processReceiveCompletion(&wc, buffer, bytesWritten, immediateValue, immediateValueValid, queuePair);
+		if (consumedBuffer != NULL) {
+			postReceiveBuffer(consumedBuffer);
+		}
+		replenishReceiveBuffers();
+		replenishNotificationReceives();
+		return true;
+	}
+
+	// Buffers released while none were posted produce no completion, so refill on empty polls as well
+	replenishReceiveBuffers();
+	return false;
+
+}
+
+uint32_t CompletionQueueGroup::receiveBatch(receive_element_t* receiveElements, uint32_t maxNumberOfElements) {
+
+	ibv_wc wc[Configuration::MAX_COMPLETION_BATCH_SIZE];
+	infinity::memory::Buffer *consumedBuffers[Configuration::MAX_COMPLETION_BATCH_SIZE];
+	uint32_t numberOfElements = 0;
+
+	while (numberOfElements < maxNumberOfElements) {
+
+		int32_t batchSize = MIN(maxNumberOfElements - numberOfElements, Configuration::MAX_COMPLETION_BATCH_SIZE);
+		int32_t numberOfCompletions = ibv_poll_cq(this->ibvReceiveCompletionQueue, batchSize, wc);
+		uint32_t numberOfConsumedBuffers = 0;
+
+		for (int32_t i = 0; i < numberOfCompletions; ++i) {
+			receive_element_t *receiveElement = &(receiveElements[numberOfElements + i]);
+			infinity::memory::Buffer *consumedBuffer = processReceiveCompletion(&(wc[i]), &(receiveElement->buffer), &(receiveElement->bytesWritten),
+					&(receiveElement->immediateValue), &(receiveElement->immediateValueValid), &(receiveElement->queuePair), &(receiveElement->queuePairContext));
+			if (consumedBuffer != NULL) {
+				consumedBuffers[numberOfConsumedBuffers++] = consumedBuffer;
+			}
+		}
+
+		// Buffers consumed by writes with immediate are reposted with a single call
+		if (numberOfConsumedBuffers > 0) {
+			postReceiveBuffers(consumedBuffers, numberOfConsumedBuffers);
+		}
+
+		if (numberOfCompletions <= 0) {
+			break;
+		}
+		numberOfElements += numberOfCompletions;
+		if (numberOfCompletions < batchSize) {
+			break;
+		}
+
+	}
+
+	replenishReceiveBuffers();
+	if (numberOfElements > 0) {
+		replenishNotificationReceives();
+	}
+
+	return numberOfElements;
+
+}
+
+bool CompletionQueueGroup::waitUntilReceived(receive_element_t* receiveElement, int32_t timeoutInMilliseconds) {
+
+	uint64_t startTime = getTimeInMicroseconds();
+	uint64_t timeout = static_cast<uint64_t>(timeoutInMilliseconds) * 1000;
+
+	// Spin first, most messages on busy connections arrive within a few microseconds
+	while (true) {
+		if (receive(receiveElement)) {
+			return true;
+		}
+		uint64_t elapsedTime = getTimeInMicroseconds() - startTime;
+		if (timeoutInMilliseconds >= 0 && elapsedTime >= timeout) {
+			return false;
+		}
+		if (this->ibvReceiveCompletionChannel != NULL && elapsedTime >= this->context->getConfiguration()->completionSpinTime) {
+			break;
+		}
+	}
+
+	// Arm the queue and sleep until the next completion
+	while (true) {
+		armReceiveCompletionQueue();
+		if (receive(receiveElement)) {
+			return true;
+		}
+		int32_t waitTime = Configuration::COMPLETION_EVENT_RECHECK_INTERVAL;
+		if (timeoutInMilliseconds >= 0) {
+			uint64_t elapsedTime = getTimeInMicroseconds() - startTime;
+			if (elapsedTime >= timeout) {
+				return false;
+			}
+			waitTime = MIN(waitTime, static_cast<int32_t>((timeout - elapsedTime + 999) / 1000));
+		}
+		waitForReceiveCompletionEvent(waitTime);
+	}
+
+}
+
+infinity::memory::Buffer* CompletionQueueGroup::processReceiveCompletion(ibv_wc* wc, infinity::memory::Buffer** buffer, uint32_t* bytesWritten, uint32_t* immediateValue,
+		bool* immediateValueValid, infinity::queues::QueuePair** queuePair, void** queuePairContext) {
+
+	infinity::memory::Buffer *consumedBuffer = NULL;
+
+	if (wc->wr_id == 0) {
+		*(buffer) = NULL;
+		*(bytesWritten) = wc->byte_len;
+		++this->consumedNotificationReceives;
+	} else if(wc->opcode == IBV_WC_RECV) {
+		*(buffer) = reinterpret_cast<infinity::memory::Buffer*>(wc->wr_id);
+		*(bytesWritten) = wc->byte_len;
+		if (this->receiveBufferPool != NULL && this->receiveBufferPool->ownsBuffer(*(buffer))) {
+			this->receiveBufferPool->onBufferConsumed();
+		}
+	} else if (wc->opcode == IBV_WC_RECV_RDMA_WITH_IMM) {
+		*(buffer) = NULL;
+		*(bytesWritten) = wc->byte_len;
+		consumedBuffer = reinterpret_cast<infinity::memory::Buffer*>(wc->wr_id);
+	}
+
+	if(wc->wc_flags & IBV_WC_WITH_IMM) {
+		*(immediateValue) = ntohl(wc->imm_data);
+		*(immediateValueValid) = true;
+	} else {
+		*(immediateValue) = 0;
+		*(immediateValueValid) = false;
+	}
+
+	if(queuePair != NULL) {
+		*(queuePair) = this->queuePairTable.lookup(wc->qp_num, queuePairContext);
+		INFINITY_ASSERT(*(queuePair) != NULL, "[INFINITY][CORE][GROUP] Received message on unknown queue pair %u.\n", wc->qp_num);
+	}
+
+	return consumedBuffer;
+
+}
+
+bool CompletionQueueGroup::pollSendCompletionQueue() {
+
+	ibv_wc wc;
+	if (ibv_poll_cq(this->ibvSendCompletionQueue, 1, &wc) > 0) {
+		processSendCompletion(&wc);
+		return true;
+	}
+
+	return false;
+
+}
+
+uint32_t CompletionQueueGroup::pollSendCompletionQueue(uint32_t maxNumberOfCompletions) {
+
+	ibv_wc wc[Configuration::MAX_COMPLETION_BATCH_SIZE];
+	uint32_t numberOfCompletions = 0;
+
+	while (numberOfCompletions < maxNumberOfCompletions) {
+
+		int32_t batchSize = MIN(maxNumberOfCompletions - numberOfCompletions, Configuration::MAX_COMPLETION_BATCH_SIZE);
+		int32_t numberOfPolledCompletions = ibv_poll_cq(this->ibvSendCompletionQueue, batchSize, wc);
+
+		for (int32_t i = 0; i < numberOfPolledCompletions; ++i) {
+			processSendCompletion(&(wc[i]));
+		}
+
+		if (numberOfPolledCompletions <= 0) {
+			break;
+		}
+		numberOfCompletions += numberOfPolledCompletions;
+		if (numberOfPolledCompletions < batchSize) {
+			break;
+		}
+
+	}
+
+	return numberOfCompletions;
+
+}
+
+void CompletionQueueGroup::waitForSendCompletions(CompletionCondition completionCondition, void* conditionContext) {
+
+	// Completions are delivered by the progress engine, unless it is the one waiting (e.g. in a completion callback)
+	while (!completionCondition(conditionContext) && hasProgressEngine() && !isProgressEngineThread()) {
+		std::this_thread::yield();
+	}
+
+	if (this->ibvSendCompletionChannel == NULL) {
+		while (!completionCondition(conditionContext)) {
+			pollSendCompletionQueue(Configuration::MAX_COMPLETION_BATCH_SIZE);
+		}
+		return;
+	}
+
+	// Spin for a bounded time, then arm the completion queue and sleep
+	uint64_t startTime = getTimeInMicroseconds();
+	while (!completionCondition(conditionContext)) {
+		pollSendCompletionQueue(Configuration::MAX_COMPLETION_BATCH_SIZE);
+		if (getTimeInMicroseconds() - startTime >= this->context->getConfiguration()->completionSpinTime) {
+			break;
+		}
+	}
+
+	while (!completionCondition(conditionContext)) {
+		armSendCompletionQueue();
+		pollSendCompletionQueue(Configuration::MAX_COMPLETION_BATCH_SIZE);
+		if (completionCondition(conditionContext)) {
+			break;
+		}
+		waitForSendCompletionEvent(Configuration::COMPLETION_EVENT_RECHECK_INTERVAL);
+		pollSendCompletionQueue(Configuration::MAX_COMPLETION_BATCH_SIZE);
+	}
+
+}
+
+bool CompletionQueueGroup::hasCompletionChannels() {
+	return this->ibvSendCompletionChannel != NULL;
+}
+
+int CompletionQueueGroup::getSendCompletionChannelFd() {
+	return (this->ibvSendCompletionChannel != NULL) ? this->ibvSendCompletionChannel->fd : -1;
+}
+
+int CompletionQueueGroup::getReceiveCompletionChannelFd() {
+	return (this->ibvReceiveCompletionChannel != NULL) ? this->ibvReceiveCompletionChannel->fd : -1;
+}
+
+void CompletionQueueGroup::armSendCompletionQueue() {
+	INFINITY_ASSERT(this->ibvSendCompletionChannel != NULL, "[INFINITY][CORE][GROUP] Completion channels are not enabled.\n");
+	int returnValue = ibv_req_notify_cq(this->ibvSendCompletionQueue, 0);
+	INFINITY_ASSERT(returnValue == 0, "[INFINITY][CORE][GROUP] Cannot arm send completion queue.\n");
+}
+
+void CompletionQueueGroup::armReceiveCompletionQueue() {
+	INFINITY_ASSERT(this->ibvReceiveCompletionChannel != NULL, "[INFINITY][CORE][GROUP] Completion channels are not enabled.\n");
+	int returnValue = ibv_req_notify_cq(this->ibvReceiveCompletionQueue, 0);
+	INFINITY_ASSERT(returnValue == 0, "[INFINITY][CORE][GROUP] Cannot arm receive completion queue.\n");
+}
+
+bool CompletionQueueGroup::waitForSendCompletionEvent(int32_t timeoutInMilliseconds) {
+	return waitForCompletionEvent(this->ibvSendCompletionChannel, timeoutInMilliseconds);
+}
+
+bool CompletionQueueGroup::waitForReceiveCompletionEvent(int32_t timeoutInMilliseconds) {
+	return waitForCompletionEvent(this->ibvReceiveCompletionChannel, timeoutInMilliseconds);
+}
+
+bool CompletionQueueGroup::waitForCompletionEvent(ibv_comp_channel* completionChannel, int32_t timeoutInMilliseconds) {
+
+	INFINITY_ASSERT(completionChannel != NULL, "[INFINITY][CORE][GROUP] Completion channels are not enabled.\n");
+
+	pollfd channelFd;
+	channelFd.fd = completionChannel->fd;
+	channelFd.events = POLLIN;
+	channelFd.revents = 0;
+	if (poll(&channelFd, 1, timeoutInMilliseconds) <= 0) {
+		return false;
+	}
+
+	// Another thread may have consumed the event in the meantime, the channel is non-blocking
+	ibv_cq *completionQueue;
+	void *completionQueueContext;
+	uint32_t numberOfEvents = 0;
+	while (ibv_get_cq_event(completionChannel, &completionQueue, &completionQueueContext) == 0) {
+		ibv_ack_cq_events(completionQueue, 1);
+		++numberOfEvents;
+	}
+
+	return numberOfEvents > 0;
+
+}
+
+void CompletionQueueGroup::processSendCompletion(ibv_wc* wc) {
+
+	infinity::queues::QueuePair *queuePair = this->queuePairTable.lookup(wc->qp_num);
+	if (queuePair != NULL) {
+		queuePair->retireSignaledWorkRequest(wc->status == IBV_WC_SUCCESS);
+	}
+
+	infinity::requests::RequestToken * request = reinterpret_cast<infinity::requests::RequestToken*>(wc->wr_id);
+	if (request != NULL) {
+		request->setCompleted(wc->status == IBV_WC_SUCCESS);
+	}
+
+	if (wc->status == IBV_WC_SUCCESS) {
+		INFINITY_DEBUG("[INFINITY][CORE][GROUP] Request completed (id %lu).\n", wc->wr_id);
+	} else {
+		INFINITY_DEBUG("[INFINITY][CORE][GROUP] Request failed (id %lu).\n", wc->wr_id);
+	}
+
+}
+
+void CompletionQueueGroup::registerQueuePair(infinity::queues::QueuePair* queuePair) {
+	this->queuePairTable.insert(queuePair->getQueuePairNumber(), queuePair, queuePair->getUserContext());
+}
+
+void CompletionQueueGroup::unregisterQueuePair(infinity::queues::QueuePair* queuePair) {
+	this->queuePairTable.remove(queuePair->getQueuePairNumber(), queuePair);
+}
+
+void CompletionQueueGroup::replenishReceiveBuffers() {
+	if (this->receiveBufferPool != NULL && this->receiveBufferPool->needsReplenishment()) {
+		this->receiveBufferPool->replenish();
+	}
+}
+
+void CompletionQueueGroup::onSharedReceiveQueueLimitReached() {
+
+	// The limit event is one-shot and has to be armed again
+	if (this->receiveBufferPool != NULL) {
+		this->receiveBufferPool->replenish();
+		this->receiveBufferPool->armLimitEvent();
+	}
+
+}
+
+infinity::memory::ReceiveBufferPool* CompletionQueueGroup::getReceiveBufferPool() {
+	return this->receiveBufferPool;
+}
+
+Context* CompletionQueueGroup::getContext() {
+	return this->context;
+}
+
+bool CompletionQueueGroup::hasProgressEngine() {
+	return this->progressEngineAttached.load(std::memory_order_relaxed);
+}
+
+bool CompletionQueueGroup::isProgressEngineThread() {
+	return hasProgressEngine() && this->progressEngineThread.load(std::memory_order_relaxed) == std::this_thread::get_id();
+}
+
+ibv_cq* CompletionQueueGroup::getSendCompletionQueue() {
+	return this->ibvSendCompletionQueue;
+}
+
+ibv_cq* CompletionQueueGroup::getReceiveCompletionQueue() {
+	return this->ibvReceiveCompletionQueue;
+}
+
+ibv_srq* CompletionQueueGroup::getSharedReceiveQueue() {
+	return this->ibvSharedReceiveQueue;
+}
+
+ibv_srq* CompletionQueueGroup::getNotificationQueue() {
+	return this->ibvNotificationQueue;
+}
+
+} /* namespace core */
+} /* namespace infinity */
@@ -0,0 +1,246 @@
+/**
+ * Core - Completion Queue Group
+ *
+ * (c) 2018 Claude Barthels, ETH Zurich
+ * Contact: claudeb@inf.ethz.ch
+ *
+ */
+
+#ifndef CORE_COMPLETIONQUEUEGROUP_H_
+#define CORE_COMPLETIONQUEUEGROUP_H_
+
+#include <atomic>
+#include <stdint.h>
+#include <thread>
+#include <infiniband/verbs.h>
+
+#include <infinity/core/Context.h>
+#include <infinity/queues/QueuePairTable.h>
+
+namespace infinity {
+namespace memory {
+class ReceiveBufferPool;
+}
+namespace queues {
+class FlowControlledQueuePair;
+}
+}
+
+namespace infinity {
+namespace core {
+
+class ProgressEngine;
+
+/**
+ * Send and receive completion queues and a shared receive queue on the protection domain of a context
+ * Queue pairs created on a group only complete into this group, a group should be polled by a single thread
+ */
+class CompletionQueueGroup {
+
+	friend class infinity::core::Context;
+	friend class infinity::core::ProgressEngine;
+	friend class infinity::memory::ReceiveBufferPool;
+	friend class infinity::queues::FlowControlledQueuePair;
+	friend class infinity::queues::QueuePair;
+	friend class infinity::queues::QueuePairFactory;
+	friend class infinity::requests::RequestToken;
+
+public:
+
+	/**
+	 * Queues are sized according to the configuration of the context
+	 */
+	CompletionQueueGroup(Context *context);
+	~CompletionQueueGroup();
+
+public:
+
+	/**
+	 * Check if receive operation completed
+	 */
+	bool receive(receive_element_t *receiveElement);
+	bool receive(infinity::memory::Buffer **buffer, uint32_t *bytesWritten, uint32_t *immediateValue, bool *immediateValueValid,
+			infinity::queues::QueuePair **queuePair = NULL);
+
+	/**
+	 * Drain up to maxNumberOfElements receive completions, returns the number of elements filled
+	 */
+	uint32_t receiveBatch(receive_element_t *receiveElements, uint32_t maxNumberOfElements);
+
+	/**
+	 * Busy-poll for a message for the configured spin time, then block on the completion channel (if enabled)
+	 * Returns false if no message arrived within the timeout (-1 to wait forever)
+	 */
+	bool waitUntilReceived(receive_element_t *receiveElement, int32_t timeoutInMilliseconds = -1);
+
+	/**
+	 * Post a new buffer for receiving messages
+	 */
+	void postReceiveBuffer(infinity::memory::Buffer *buffer);
+
+	/**
+	 * Post several buffers, chained into one ibv_post_srq_recv per MAX_COMPLETION_BATCH_SIZE buffers
+	 */
+	void postReceiveBuffers(infinity::memory::Buffer **buffers, uint32_t numberOfBuffers);
+
+	/**
+	 * Returns true if the group has a queue of zero-length receives (see Configuration::notificationQueueLength)
+	 * Writes with immediate arriving there are returned with a NULL buffer and are replenished automatically
+	 */
+	bool hasNotificationQueue();
+
+public:
+
+	/**
+	 * Evaluated by a waiting thread after completions were processed, returns true once the wait is over
+	 */
+	typedef bool (*CompletionCondition)(void *conditionContext);
+
+	/**
+	 * Drain up to maxNumberOfCompletions send completions and notify their request tokens, returns the number of completions
+	 */
+	uint32_t pollSendCompletionQueue(uint32_t maxNumberOfCompletions);
+
+	/**
+	 * Process send completions until the condition holds, yields while a progress engine is attached,
+	 * otherwise busy-polls for the configured spin time and then blocks on the completion channel (if enabled)
+	 */
+	void waitForSendCompletions(CompletionCondition completionCondition, void *conditionContext);
+
+public:
+
+	/**
+	 * Returns true if the completion queues were created with completion channels
+	 */
+	bool hasCompletionChannels();
+
+	/**
+	 * Non-blocking file descriptors of the completion channels (-1 if disabled), can be added to epoll
+	 */
+	int getSendCompletionChannelFd();
+	int getReceiveCompletionChannelFd();
+
+	/**
+	 * Request an event for the next completion, the queue must be polled once more after arming to not miss completions
+	 */
+	void armSendCompletionQueue();
+	void armReceiveCompletionQueue();
+
+	/**
+	 * Wait for an event on the completion channel and acknowledge it, returns true if an event was consumed
+	 */
+	bool waitForSendCompletionEvent(int32_t timeoutInMilliseconds);
+	bool waitForReceiveCompletionEvent(int32_t timeoutInMilliseconds);
+
+public:
+
+	Context * getContext();
+
+	/**
+	 * Receive buffer pool which keeps the shared receive queue filled (NULL if none was attached), deleted with the group
+	 */
+	infinity::memory::ReceiveBufferPool * getReceiveBufferPool();
+
+	/**
+	 * Returns true while a progress engine polls this group, waiting threads then only observe their request tokens
+	 */
+	bool hasProgressEngine();
+
+	/**
+	 * Returns true if called on the thread of the progress engine, which has to poll itself instead of waiting for the engine
+	 */
+	bool isProgressEngineThread();
+
+protected:
+
+	/**
+	 * Check if send operation completed
+	 */
+	bool pollSendCompletionQueue();
+
+	/**
+	 * Returns ibVerbs queues
+	 */
+	ibv_cq * getSendCompletionQueue();
+	ibv_cq * getReceiveCompletionQueue();
+	ibv_srq * getSharedReceiveQueue();
+	ibv_srq * getNotificationQueue();
+
+	/**
+	 * Consume and acknowledge events of a completion channel
+	 */
+	bool waitForCompletionEvent(ibv_comp_channel *completionChannel, int32_t timeoutInMilliseconds);
+
+	/**
+	 * Dispatch a single work completion
+	 */
+	void processSendCompletion(ibv_wc *wc);
+
+	/**
+	 * Post zero-length receives to the notification queue, consumed ones are reposted in batches
+	 */
+	void postNotificationReceives(uint32_t numberOfReceives);
+	void replenishNotificationReceives();
+
+	/**
+	 * Refill the shared receive queue from the attached receive buffer pool
+	 */
+	void replenishReceiveBuffers();
+	void onSharedReceiveQueueLimitReached();
+
+	/**
+	 * Dispatch a single receive completion, returns the receive buffer consumed by a write with immediate
+	 * which has to be reposted by the caller (NULL otherwise)
+	 */
+	infinity::memory::Buffer * processReceiveCompletion(ibv_wc *wc, infinity::memory::Buffer **buffer, uint32_t *bytesWritten, uint32_t *immediateValue, bool *immediateValueValid,
+			infinity::queues::QueuePair **queuePair, void **queuePairContext = NULL);
+
+protected:
+
+	Context * const context;
+
+	/**
+	 * IB send and receive completion queues
+	 */
+	ibv_cq *ibvSendCompletionQueue;
+	ibv_cq *ibvReceiveCompletionQueue;
+	ibv_srq *ibvSharedReceiveQueue;
+
+	/**
+	 * Shared receive queue of zero-length receives (NULL if disabled)
+	 */
+	ibv_srq *ibvNotificationQueue;
+	uint32_t notificationQueueLength;
+	uint32_t consumedNotificationReceives;
+
+	/**
+	 * IB completion channels (NULL if disabled)
+	 */
+	ibv_comp_channel *ibvSendCompletionChannel;
+	ibv_comp_channel *ibvReceiveCompletionChannel;
+
+	std::atomic<bool> progressEngineAttached;
+	std::atomic<std::thread::id> progressEngineThread;
+
+	infinity::memory::ReceiveBufferPool *receiveBufferPool;
+
+	/**
+	 * Receive buffers promised to the peers of flow controlled queue pairs on this group
+	 */
+	std::atomic<uint32_t> numberOfReservedReceiveBuffers;
+
+protected:
+
+	/**
+	 * Queue pairs completing into this group, registering again updates the user context of the queue pair
+	 */
+	void registerQueuePair(infinity::queues::QueuePair *queuePair);
+	void unregisterQueuePair(infinity::queues::QueuePair *queuePair);
+	infinity::queues::QueuePairTable queuePairTable;
+
+};
+
+} /* namespace core */
+} /* namespace infinity */
+
+#endif /* CORE_COMPLETIONQUEUEGROUP_H_ */
@@ -0,0 +1,105 @@
+/**
+ * Core - Configuration
+ *
+ * (c) 2018 Claude Barthels, ETH Zurich
+ * Contact: claudeb@inf.ethz.ch
+ *
+ */
+
+#include "Configuration.h"
+
+#include <infinity/utils/Debug.h>
+
+namespace infinity {
+namespace core {
+
+static void limitSetting(uint32_t *value, uint32_t minimum, uint32_t maximum, const char *name) {
+
+	if (*value > maximum) {
+		INFINITY_DEBUG("[INFINITY][CORE][CONFIGURATION] Reducing %s from %u to device limit %u.\n", name, *value, maximum);
+		*value = maximum;
+	}
+	if (*value < minimum) {
+		INFINITY_DEBUG("[INFINITY][CORE][CONFIGURATION] Raising %s from %u to %u.\n", name, *value, minimum);
+		*value = minimum;
+	}
+
+}
+
+static void limitSetting(uint8_t *value, uint8_t maximum, const char *name) {
+
+	if (*value > maximum) {
+		INFINITY_DEBUG("[INFINITY][CORE][CONFIGURATION] Reducing %s from %u to %u.\n", name, *value, maximum);
+		*value = maximum;
+	}
+
+}
+
+Configuration::Configuration() {
+
+	this->sendCompletionQueueLength = SEND_COMPLETION_QUEUE_LENGTH;
+	this->receiveCompletionQueueLength = RECV_COMPLETION_QUEUE_LENGTH;
+	this->sharedReceiveQueueLength = SHARED_RECV_QUEUE_LENGTH;
+
+	this->sendQueueLength = SEND_COMPLETION_QUEUE_LENGTH;
+	this->receiveQueueLength = RECV_COMPLETION_QUEUE_LENGTH;
+
+	this->maxNumberOfSendSgeElements = MAX_NUMBER_OF_SEND_SGE_ELEMENTS;
+	this->maxNumberOfReceiveSgeElements = MAX_NUMBER_OF_SGE_ELEMENTS;
+
+	this->maxInlineDataSize = MAX_INLINE_DATA_SIZE;
+
+	this->signalingInterval = 0;
+
+	this->useCompletionChannels = false;
+	this->completionSpinTime = COMPLETION_SPIN_TIME;
+
+	this->receiveBufferPoolSize = 0;
+	this->receiveBufferSize = RECEIVE_BUFFER_SIZE;
+	this->receiveBufferLowWatermark = 0;
+
+	this->notificationQueueLength = 0;
+	this->useNotificationQueue = false;
+
+	this->pathMtu = IBV_MTU_4096;
+
+	this->timeout = 14;
+	this->retryCount = 7;
+	this->rnrRetryCount = 7;
+	this->minRnrTimer = 12;
+
+	this->maxOutstandingReadAtomicOperations = 0;
+
+	this->allocateOnDeviceNumaNode = true;
+
+}
+
+void Configuration::validate(ibv_device_attr* deviceAttributes, ibv_port_attr* portAttributes) {
+
+	limitSetting(&(this->sendCompletionQueueLength), 1, deviceAttributes->max_cqe, "send completion queue length");
+	limitSetting(&(this->receiveCompletionQueueLength), 1, deviceAttributes->max_cqe, "receive completion queue length");
+	limitSetting(&(this->sharedReceiveQueueLength), 1, deviceAttributes->max_srq_wr, "shared receive queue length");
+	limitSetting(&(this->notificationQueueLength), 0, deviceAttributes->max_srq_wr, "notification queue length");
+
+	limitSetting(&(this->sendQueueLength), 1, deviceAttributes->max_qp_wr, "send queue length");
+	limitSetting(&(this->receiveQueueLength), 1, deviceAttributes->max_qp_wr, "receive queue length");
+
+	limitSetting(&(this->maxNumberOfSendSgeElements), 1, deviceAttributes->max_sge, "number of send scatter-gather elements");
+	limitSetting(&(this->maxNumberOfReceiveSgeElements), 1, deviceAttributes->max_srq_sge, "number of receive scatter-gather elements");
+
+	limitSetting(&(this->signalingInterval), 0, this->sendQueueLength / 2, "signaling interval");
+
+	if (this->pathMtu > portAttributes->active_mtu) {
+		INFINITY_DEBUG("[INFINITY][CORE][CONFIGURATION] Reducing path MTU to active MTU of port.\n");
+		this->pathMtu = portAttributes->active_mtu;
+	}
+
+	limitSetting(&(this->timeout), 31, "timeout");
+	limitSetting(&(this->retryCount), 7, "retry count");
+	limitSetting(&(this->rnrRetryCount), 7, "RNR retry count");
+	limitSetting(&(this->minRnrTimer), 31, "minimal RNR timer");
+
+}
+
+} /* namespace core */
+} /* namespace infinity */
@@ -8,18 +8,18 @@
 
 #include "Context.h"
 
+#include <poll.h>
 #include <string.h>
-#include <limits>
-#include <arpa/inet.h>
 
+#include <infinity/core/CompletionQueueGroup.h>
 #include <infinity/core/Configuration.h>
 #include <infinity/queues/QueuePair.h>
 #include <infinity/memory/Atomic.h>
 #include <infinity/memory/Buffer.h>
+#include <infinity/memory/ReceiveBufferPool.h>
 #include <infinity/requests/RequestToken.h>
 #include <infinity/utils/Debug.h>
-
-#define MAX(a,b) ((a) > (b) ? (a) : (b))
+#include <infinity/utils/Numa.h>
 
 namespace infinity {
 namespace core {
@@ -28,7 +28,23 @@ namespace core {
  * Context
  ******************************/
 
-Context::Context(uint16_t device, uint16_t devicePort) {
+Context::Context(uint16_t device, uint16_t devicePort) :
+		Context(Configuration(), device, devicePort) {
+
+}
+
+Context::Context(const std::string &deviceName, uint16_t devicePort) :
+		Context(Configuration(), getDeviceIndex(deviceName), devicePort) {
+
+}
+
+Context::Context(const Configuration &configuration, const std::string &deviceName, uint16_t devicePort) :
+		Context(configuration, getDeviceIndex(deviceName), devicePort) {
+
+}
+
+Context::Context(const Configuration &configuration, uint16_t device, uint16_t devicePort) :
+		configuration(configuration) {
 
 	// Get IB device list
 	int32_t numberOfInstalledDevices = 0;
@@ -41,6 +57,8 @@ Context::Context(uint16_t device, uint16_t devicePort) {
 	// Get IB device
 	this->ibvDevice = ibvDeviceList[device];
 	INFINITY_ASSERT(this->ibvDevice != NULL, "[INFINITY][CORE][CONTEXT] Requested device %d was NULL.\n", device);
+	this->numaNode = infinity::utils::Numa::getNumaNodeOfDevice(this->ibvDevice);
+	INFINITY_DEBUG("[INFINITY][CORE][CONTEXT] Opening device %s on NUMA node %d.\n", ibv_get_device_name(this->ibvDevice), this->numaNode);
 
 	// Open IB device and allocate protection domain
 	this->ibvContext = ibv_open_device(this->ibvDevice);
@@ -48,24 +66,27 @@ Context::Context(uint16_t device, uint16_t devicePort) {
 	this->ibvProtectionDomain = ibv_alloc_pd(this->ibvContext);
 	INFINITY_ASSERT(this->ibvProtectionDomain != NULL, "[INFINITY][CORE][CONTEXT] Could not allocate protection domain.\n");
 
+	// Query device limits
+	int32_t returnValue = ibv_query_device(this->ibvContext, &(this->ibvDeviceAttributes));
+	INFINITY_ASSERT(returnValue == 0, "[INFINITY][CORE][CONTEXT] Could not query device attributes.\n");
+
 	// Get the LID
-	ibv_port_attr portAttributes;
-	ibv_query_port(this->ibvContext, devicePort, &portAttributes);
-	this->ibvLocalDeviceId = portAttributes.lid;
+	ibv_query_port(this->ibvContext, devicePort, &(this->ibvPortAttributes));
+	this->ibvLocalDeviceId = this->ibvPortAttributes.lid;
 	this->ibvDevicePort = devicePort;
 
-	// Allocate completion queues
-	this->ibvSendCompletionQueue = ibv_create_cq(this->ibvContext, MAX(Configuration::SEND_COMPLETION_QUEUE_LENGTH, 1), NULL, NULL, 0);
-	this->ibvReceiveCompletionQueue = ibv_create_cq(this->ibvContext, MAX(Configuration::RECV_COMPLETION_QUEUE_LENGTH, 1), NULL, NULL, 0);
+	// Fit configuration to device limits
+	this->configuration.validate(&(this->ibvDeviceAttributes), &(this->ibvPortAttributes));
+
+	// Allocate default completion queues and shared receive queue
+	this->defaultCompletionQueueGroup = new CompletionQueueGroup(this);
 
-	// Allocate shared receive queue
-	ibv_srq_init_attr sia;
-	memset(&sia, 0, sizeof(ibv_srq_init_attr));
-	sia.srq_context = this->ibvContext;
-	sia.attr.max_wr = MAX(Configuration::SHARED_RECV_QUEUE_LENGTH, 1);
-	sia.attr.max_sge = 1;
-	this->ibvSharedReceiveQueue = ibv_create_srq(this->ibvProtectionDomain, &sia);
-	INFINITY_ASSERT(this->ibvSharedReceiveQueue != NULL, "[INFINITY][CORE][CONTEXT] Could not allocate shared receive queue.\n");
+	// Keep the shared receive queue filled from a pool if requested
+	this->receiveBufferPool = NULL;
+	if (this->configuration.receiveBufferPoolSize > 0) {
+		this->receiveBufferPool = new infinity::memory::ReceiveBufferPool(this->defaultCompletionQueueGroup, this->configuration.receiveBufferPoolSize,
+				this->configuration.receiveBufferSize, this->configuration.receiveBufferLowWatermark);
+	}
 
 	// Create a default request token
 	defaultRequestToken = new infinity::requests::RequestToken(this);
@@ -79,18 +100,11 @@ Context::~Context() {
 	delete defaultRequestToken;
 	delete defaultAtomic;
 
-	// Destroy shared receive queue
-	int returnValue = ibv_destroy_srq(this->ibvSharedReceiveQueue);
-	INFINITY_ASSERT(returnValue == 0, "[INFINITY][CORE][CONTEXT] Could not delete shared receive queue\n");
-
-	// Destroy completion queues
-	returnValue = ibv_destroy_cq(this->ibvSendCompletionQueue);
-	INFINITY_ASSERT(returnValue == 0, "[INFINITY][CORE][CONTEXT] Could not delete send completion queue\n");
-	returnValue = ibv_destroy_cq(this->ibvReceiveCompletionQueue);
-	INFINITY_ASSERT(returnValue == 0, "[INFINITY][CORE][CONTEXT] Could not delete receive completion queue\n");
+	// Destroy default completion queues and shared receive queue (together with the receive buffer pool)
+	delete this->defaultCompletionQueueGroup;
 
 	// Destroy protection domain
-	returnValue = ibv_dealloc_pd(this->ibvProtectionDomain);
+	int returnValue = ibv_dealloc_pd(this->ibvProtectionDomain);
 	INFINITY_ASSERT(returnValue == 0, "[INFINITY][CORE][CONTEXT] Could not delete protection domain\n");
 
 	// Close device
@@ -100,96 +114,108 @@ Context::~Context() {
 }
 
 void Context::postReceiveBuffer(infinity::memory::Buffer* buffer) {
+	this->defaultCompletionQueueGroup->postReceiveBuffer(buffer);
+}
 
-	INFINITY_ASSERT(buffer->getSizeInBytes() <= std::numeric_limits<uint32_t>::max(),
-			"[INFINITY][CORE][CONTEXT] Cannot post receive buffer which is larger than max(uint32_t).\n");
-
-	// Create scatter-getter
-	ibv_sge isge;
-	memset(&isge, 0, sizeof(ibv_sge));
-	isge.addr = buffer->getAddress();
-	isge.length = static_cast<uint32_t>(buffer->getSizeInBytes());
-	isge.lkey = buffer->getLocalKey();
-
-	// Create work request
-	ibv_recv_wr wr;
-	memset(&wr, 0, sizeof(ibv_recv_wr));
-	wr.wr_id = reinterpret_cast<uint64_t>(buffer);
-	wr.next = NULL;
-	wr.sg_list = &isge;
-	wr.num_sge = 1;
-
-	// Post buffer to shared receive queue
-	ibv_recv_wr *badwr;
-	uint32_t returnValue = ibv_post_srq_recv(this->ibvSharedReceiveQueue, &wr, &badwr);
-	INFINITY_ASSERT(returnValue == 0, "[INFINITY][CORE][CONTEXT] Cannot post buffer to receive queue.\n");
+void Context::postReceiveBuffers(infinity::memory::Buffer** buffers, uint32_t numberOfBuffers) {
+	this->defaultCompletionQueueGroup->postReceiveBuffers(buffers, numberOfBuffers);
+}
 
+infinity::memory::ReceiveBufferPool* Context::getReceiveBufferPool() {
+	return this->receiveBufferPool;
 }
 
-bool Context::receive(receive_element_t* receiveElement) {
+void Context::releaseReceiveBuffer(infinity::memory::Buffer* buffer) {
+	INFINITY_ASSERT(this->receiveBufferPool != NULL, "[INFINITY][CORE][CONTEXT] No receive buffer pool configured.\n");
+	this->receiveBufferPool->release(buffer);
+}
 
-	return receive(&(receiveElement->buffer), &(receiveElement->bytesWritten), &(receiveElement->immediateValue), &(receiveElement->immediateValueValid), &(receiveElement->queuePair));
+uint32_t Context::processAsyncEvents() {
 
-}
+	pollfd asyncEventFd;
+	asyncEventFd.fd = this->ibvContext->async_fd;
+	asyncEventFd.events = POLLIN;
+	asyncEventFd.revents = 0;
 
-bool Context::receive(infinity::memory::Buffer** buffer, uint32_t *bytesWritten, uint32_t *immediateValue, bool *immediateValueValid, infinity::queues::QueuePair **queuePair) {
+	// The async descriptor is blocking, only read it once poll reports a pending event
+	uint32_t numberOfEvents = 0;
+	while (poll(&asyncEventFd, 1, 0) > 0) {
 
-	ibv_wc wc;
-	if (ibv_poll_cq(this->ibvReceiveCompletionQueue, 1, &wc) > 0) {
-
-		if(wc.opcode == IBV_WC_RECV) {
-			*(buffer) = reinterpret_cast<infinity::memory::Buffer*>(wc.wr_id);
-			*(bytesWritten) = wc.byte_len;
-		} else if (wc.opcode == IBV_WC_RECV_RDMA_WITH_IMM) {
-			*(buffer) = NULL;
-			*(bytesWritten) = wc.byte_len;
-			infinity::memory::Buffer* receiveBuffer = reinterpret_cast<infinity::memory::Buffer*>(wc.wr_id);
-			this->postReceiveBuffer(receiveBuffer);
+		ibv_async_event asyncEvent;
+		if (ibv_get_async_event(this->ibvContext, &asyncEvent) != 0) {
+			break;
 		}
 
-		if(wc.wc_flags & IBV_WC_WITH_IMM) {
-			*(immediateValue) = ntohl(wc.imm_data);
-			*(immediateValueValid) = true;
+		if (asyncEvent.event_type == IBV_EVENT_SRQ_LIMIT_REACHED) {
+			CompletionQueueGroup *completionQueueGroup = reinterpret_cast<CompletionQueueGroup *>(asyncEvent.element.srq->srq_context);
+			completionQueueGroup->onSharedReceiveQueueLimitReached();
 		} else {
-			*(immediateValue) = 0;
-			*(immediateValueValid) = false;
+			INFINITY_DEBUG("[INFINITY][CORE][CONTEXT] Asynchronous event: %s.\n", ibv_event_type_str(asyncEvent.event_type));
 		}
 
-		if(queuePair != NULL) {
-			*(queuePair) = queuePairMap.at(wc.qp_num);
-		}
+		ibv_ack_async_event(&asyncEvent);
+		++numberOfEvents;
 
-		return true;
 	}
 
-	return false;
+	return numberOfEvents;
 
 }
 
-bool Context::pollSendCompletionQueue() {
+int Context::getAsyncEventFd() {
+	return this->ibvContext->async_fd;
+}
 
-	ibv_wc wc;
-	if (ibv_poll_cq(this->ibvSendCompletionQueue, 1, &wc) > 0) {
+bool Context::receive(receive_element_t* receiveElement) {
+	return this->defaultCompletionQueueGroup->receive(receiveElement);
+}
 
-		infinity::requests::RequestToken * request = reinterpret_cast<infinity::requests::RequestToken*>(wc.wr_id);
-		if (request != NULL) {
-			request->setCompleted(wc.status == IBV_WC_SUCCESS);
-		}
+bool Context::receive(infinity::memory::Buffer** buffer, uint32_t *bytesWritten, uint32_t *immediateValue, bool *immediateValueValid, infinity::queues::QueuePair **queuePair) {
+	return this->defaultCompletionQueueGroup->receive(buffer, bytesWritten, immediateValue, immediateValueValid, queuePair);
+}
 
-		if (wc.status == IBV_WC_SUCCESS) {
-			INFINITY_DEBUG("[INFINITY][CORE][CONTEXT] Request completed (id %lu).\n", wc.wr_id);
-		} else {
-			INFINITY_DEBUG("[INFINITY][CORE][CONTEXT] Request failed (id %lu).\n", wc.wr_id);
-		}
-		return true;
-	}
+uint32_t Context::receiveBatch(receive_element_t* receiveElements, uint32_t maxNumberOfElements) {
+	return this->defaultCompletionQueueGroup->receiveBatch(receiveElements, maxNumberOfElements);
+}
+
+bool Context::waitUntilReceived(receive_element_t* receiveElement, int32_t timeoutInMilliseconds) {
+	return this->defaultCompletionQueueGroup->waitUntilReceived(receiveElement, timeoutInMilliseconds);
+}
+
+uint32_t Context::pollSendCompletionQueue(uint32_t maxNumberOfCompletions) {
+	return this->defaultCompletionQueueGroup->pollSendCompletionQueue(maxNumberOfCompletions);
+}
 
-	return false;
+bool Context::hasCompletionChannels() {
+	return this->defaultCompletionQueueGroup->hasCompletionChannels();
+}
+
+int Context::getSendCompletionChannelFd() {
+	return this->defaultCompletionQueueGroup->getSendCompletionChannelFd();
+}
+
+int Context::getReceiveCompletionChannelFd() {
+	return this->defaultCompletionQueueGroup->getReceiveCompletionChannelFd();
+}
 
+void Context::armSendCompletionQueue() {
+	this->defaultCompletionQueueGroup->armSendCompletionQueue();
 }
 
-void Context::registerQueuePair(infinity::queues::QueuePair* queuePair) {
-	this->queuePairMap.insert({queuePair->getQueuePairNumber(), queuePair});
+void Context::armReceiveCompletionQueue() {
+	this->defaultCompletionQueueGroup->armReceiveCompletionQueue();
+}
+
+bool Context::waitForSendCompletionEvent(int32_t timeoutInMilliseconds) {
+	return this->defaultCompletionQueueGroup->waitForSendCompletionEvent(timeoutInMilliseconds);
+}
+
+bool Context::waitForReceiveCompletionEvent(int32_t timeoutInMilliseconds) {
+	return this->defaultCompletionQueueGroup->waitForReceiveCompletionEvent(timeoutInMilliseconds);
+}
+
+CompletionQueueGroup* Context::getDefaultCompletionQueueGroup() {
+	return this->defaultCompletionQueueGroup;
 }
 
 ibv_context* Context::getInfiniBandContext() {
@@ -208,16 +234,65 @@ ibv_pd* Context::getProtectionDomain() {
 	return this->ibvProtectionDomain;
 }
 
-ibv_cq* Context::getSendCompletionQueue() {
-	return this->ibvSendCompletionQueue;
+ibv_device_attr* Context::getDeviceAttributes() {
+	return &(this->ibvDeviceAttributes);
+}
+
+ibv_port_attr* Context::getPortAttributes() {
+	return &(this->ibvPortAttributes);
+}
+
+const Configuration* Context::getConfiguration() {
+	return &(this->configuration);
+}
+
+uint16_t Context::getDeviceIndex(const std::string &deviceName) {
+
+	int32_t numberOfInstalledDevices = 0;
+	ibv_device **ibvDeviceList = ibv_get_device_list(&numberOfInstalledDevices);
+	INFINITY_ASSERT(ibvDeviceList != NULL, "[INFINITY][CORE][CONTEXT] Device list was NULL.\n");
+
+	int32_t device = 0;
+	while (device < numberOfInstalledDevices && deviceName.compare(ibv_get_device_name(ibvDeviceList[device])) != 0) {
+		++device;
+	}
+	ibv_free_device_list(ibvDeviceList);
+
+	INFINITY_ASSERT(device < numberOfInstalledDevices, "[INFINITY][CORE][CONTEXT] Requested device %s not found.\n", deviceName.c_str());
+	return device;
+
+}
+
+uint16_t Context::getDeviceIndexOnNumaNode(int32_t numaNode) {
+
+	int32_t numberOfInstalledDevices = 0;
+	ibv_device **ibvDeviceList = ibv_get_device_list(&numberOfInstalledDevices);
+	INFINITY_ASSERT(ibvDeviceList != NULL, "[INFINITY][CORE][CONTEXT] Device list was NULL.\n");
+
+	int32_t device = 0;
+	while (device < numberOfInstalledDevices && infinity::utils::Numa::getNumaNodeOfDevice(ibvDeviceList[device]) != numaNode) {
+		++device;
+	}
+	ibv_free_device_list(ibvDeviceList);
+
+	if (device == numberOfInstalledDevices) {
+		INFINITY_DEBUG("[INFINITY][CORE][CONTEXT] No device attached to NUMA node %d, using device 0.\n", numaNode);
+		return 0;
+	}
+	return device;
+
+}
+
+int32_t Context::getNumaNode() {
+	return this->numaNode;
 }
 
-ibv_cq* Context::getReceiveCompletionQueue() {
-	return this->ibvReceiveCompletionQueue;
+bool Context::pinThreadToNumaNode() {
+	return infinity::utils::Numa::pinThreadToNode(this->numaNode);
 }
 
-ibv_srq* Context::getSharedReceiveQueue() {
-	return this->ibvSharedReceiveQueue;
+int32_t Context::getAllocationNumaNode() {
+	return this->configuration.allocateOnDeviceNumaNode ? this->numaNode : -1;
 }
 
 } /* namespace core */
@@ -11,14 +11,17 @@
 
 #include <stdlib.h>
 #include <stdint.h>
-#include <unordered_map>
+#include <string>
 #include <infiniband/verbs.h>
 
+#include <infinity/core/Configuration.h>
+
 namespace infinity {
 namespace memory {
 class Region;
 class Buffer;
 class Atomic;
+class ReceiveBufferPool;
 class RegisteredMemory;
 }
 }
@@ -39,12 +42,15 @@ class RequestToken;
 namespace infinity {
 namespace core {
 
+class CompletionQueueGroup;
+
 typedef struct {
 	infinity::memory::Buffer *buffer;
 	uint32_t bytesWritten;
 	uint32_t immediateValue;
 	bool immediateValueValid;
 	infinity::queues::QueuePair *queuePair;
+	void *queuePairContext;
 } receive_element_t;
 
 class Context {
@@ -56,6 +62,7 @@ class Context {
 	friend class infinity::queues::QueuePair;
 	friend class infinity::queues::QueuePairFactory;
 	friend class infinity::requests::RequestToken;
+	friend class infinity::core::CompletionQueueGroup;
 
 public:
 
@@ -63,6 +70,9 @@ public:
 	 * Constructors
 	 */
 	Context(uint16_t device = 0, uint16_t devicePort = 1);
+	Context(const Configuration &configuration, uint16_t device = 0, uint16_t devicePort = 1);
+	Context(const std::string &deviceName, uint16_t devicePort = 1);
+	Context(const Configuration &configuration, const std::string &deviceName, uint16_t devicePort = 1);
 
 	/**
 	 * Destructor
@@ -71,17 +81,119 @@ public:
 
 public:
 
+	/**
+	 * Operations on the default completion queue group, queue pairs created on other groups complete there instead
+	 */
+
 	/**
 	 * Check if receive operation completed
 	 */
 	bool receive(receive_element_t *receiveElement);
 	bool receive(infinity::memory::Buffer **buffer, uint32_t *bytesWritten, uint32_t *immediateValue, bool *immediateValueValid, infinity::queues::QueuePair **queuePair = NULL);
 
+	/**
+	 * Drain up to maxNumberOfElements receive completions, returns the number of elements filled
+	 */
+	uint32_t receiveBatch(receive_element_t *receiveElements, uint32_t maxNumberOfElements);
+
+	/**
+	 * Busy-poll for a message for the configured spin time, then block on the completion channel (if enabled)
+	 * Returns false if no message arrived within the timeout (-1 to wait forever)
+	 */
+	bool waitUntilReceived(receive_element_t *receiveElement, int32_t timeoutInMilliseconds = -1);
+
 	/**
 	 * Post a new buffer for receiving messages
 	 */
 	void postReceiveBuffer(infinity::memory::Buffer *buffer);
 
+	/**
+	 * Post several buffers with chained work requests
+	 */
+	void postReceiveBuffers(infinity::memory::Buffer **buffers, uint32_t numberOfBuffers);
+
+	/**
+	 * Receive buffer pool of the default group, created if receiveBufferPoolSize is configured (NULL otherwise)
+	 * Messages received into pool buffers are handed back with releaseReceiveBuffer() instead of being reposted
+	 */
+	infinity::memory::ReceiveBufferPool * getReceiveBufferPool();
+	void releaseReceiveBuffer(infinity::memory::Buffer *buffer);
+
+public:
+
+	/**
+	 * Drain up to maxNumberOfCompletions send completions and notify their request tokens, returns the number of completions
+	 */
+	uint32_t pollSendCompletionQueue(uint32_t maxNumberOfCompletions);
+
+public:
+
+	/**
+	 * Returns true if the completion queues were created with completion channels
+	 */
+	bool hasCompletionChannels();
+
+	/**
+	 * Non-blocking file descriptors of the completion channels (-1 if disabled), can be added to epoll
+	 * The descriptor becomes readable once an armed completion queue receives a completion
+	 */
+	int getSendCompletionChannelFd();
+	int getReceiveCompletionChannelFd();
+
+	/**
+	 * Request an event for the next completion, the queue must be polled once more after arming to not miss completions
+	 */
+	void armSendCompletionQueue();
+	void armReceiveCompletionQueue();
+
+	/**
+	 * Wait for an event on the completion channel and acknowledge it, returns true if an event was consumed
+	 * A timeout of 0 only consumes pending events, -1 waits forever
+	 */
+	bool waitForSendCompletionEvent(int32_t timeoutInMilliseconds);
+	bool waitForReceiveCompletionEvent(int32_t timeoutInMilliseconds);
+
+public:
+
+	/**
+	 * Returns the configuration of this context (validated against the device)
+	 */
+	const Configuration * getConfiguration();
+
+	/**
+	 * Returns the completion queues and shared receive queue used by queue pairs which are not bound to a group
+	 */
+	CompletionQueueGroup * getDefaultCompletionQueueGroup();
+
+	/**
+	 * Handle pending asynchronous device events without blocking, returns the number of handled events
+	 * Refills shared receive queues of groups with a receive buffer pool once their limit was reached
+	 */
+	uint32_t processAsyncEvents();
+
+	/**
+	 * File descriptor which becomes readable once an asynchronous event is pending, can be added to epoll
+	 */
+	int getAsyncEventFd();
+
+public:
+
+	/**
+	 * Device selection by name or by NUMA node (first device attached to the node, or device 0 if there is none)
+	 */
+	static uint16_t getDeviceIndex(const std::string &deviceName);
+	static uint16_t getDeviceIndexOnNumaNode(int32_t numaNode);
+
+	/**
+	 * Returns the NUMA node the device is attached to, -1 if unknown
+	 */
+	int32_t getNumaNode();
+
+	/**
+	 * Restrict the calling thread to the cores of the device's NUMA node
+	 */
+	bool pinThreadToNumaNode();
+
 public:
 
 	infinity::requests::RequestToken * defaultRequestToken;
@@ -109,27 +221,16 @@ protected:
 	 */
 	ibv_pd * getProtectionDomain();
 
-protected:
-
-	/**
-	 * Check if send operation completed
-	 */
-	bool pollSendCompletionQueue();
-
-	/**
-	 * Returns ibVerbs completion queue for sending
-	 */
-	ibv_cq * getSendCompletionQueue();
-
 	/**
-	 * Returns ibVerbs completion queue for receiving
+	 * Returns device and port attributes queried when the context was opened
 	 */
-	ibv_cq * getReceiveCompletionQueue();
+	ibv_device_attr * getDeviceAttributes();
+	ibv_port_attr * getPortAttributes();
 
 	/**
-	 * Returns ibVerbs shared receive queue
+	 * Returns the NUMA node for memory allocated by the library, -1 if placement is left to the operating system
 	 */
-	ibv_srq * getSharedReceiveQueue();
+	int32_t getAllocationNumaNode();
 
 protected:
 
@@ -143,20 +244,22 @@ protected:
 	 * Local device id and port
 	 */
 	ibv_device *ibvDevice;
+	ibv_device_attr ibvDeviceAttributes;
+	ibv_port_attr ibvPortAttributes;
 	uint16_t ibvLocalDeviceId;
 	uint16_t ibvDevicePort;
+	int32_t numaNode;
 
 	/**
-	 * IB send and receive completion queues
+	 * Default completion queues and shared receive queue
 	 */
-	ibv_cq *ibvSendCompletionQueue;
-	ibv_cq *ibvReceiveCompletionQueue;
-	ibv_srq *ibvSharedReceiveQueue;
+	CompletionQueueGroup *defaultCompletionQueueGroup;
+	infinity::memory::ReceiveBufferPool *receiveBufferPool;
 
-protected:
-
-	void registerQueuePair(infinity::queues::QueuePair *queuePair);
-	std::unordered_map<uint32_t, infinity::queues::QueuePair *> queuePairMap;
+	/**
+	 * Runtime configuration
+	 */
+	Configuration configuration;
 
 };
 
@@ -0,0 +1,176 @@
+/**
+ * Core - Progress Engine
+ *
+ * (c) 2018 Claude Barthels, ETH Zurich
+ * Contact: claudeb@inf.ethz.ch
+ *
+ */
+
+#include "ProgressEngine.h"
+
+#include <algorithm>
+
+#include <infinity/core/Configuration.h>
+#include <infinity/memory/ReceiveBufferPool.h>
+#include <infinity/queues/SubmissionQueue.h>
+#include <infinity/utils/Debug.h>
+#include <infinity/utils/Numa.h>
+
+namespace infinity {
+namespace core {
+
+ProgressEngine::ProgressEngine(Context* context, int32_t core) :
+		ProgressEngine(context->getDefaultCompletionQueueGroup(), core) {
+
+}
+
+ProgressEngine::ProgressEngine(CompletionQueueGroup* completionQueueGroup, int32_t core) :
+		completionQueueGroup(completionQueueGroup), core(core) {
+
+	this->running.store(false);
+	this->receiveCallback = NULL;
+	this->callbackContext = NULL;
+	this->submissionQueuesVersion.store(0);
+	this->acknowledgedSubmissionQueuesVersion.store(UINT64_MAX);
+
+}
+
+ProgressEngine::~ProgressEngine() {
+
+	stop();
+
+}
+
+void ProgressEngine::start() {
+
+	INFINITY_ASSERT(!this->running.load(), "[INFINITY][CORE][PROGRESS] Progress engine is already running.\n");
+	INFINITY_ASSERT(!this->completionQueueGroup->hasProgressEngine(), "[INFINITY][CORE][PROGRESS] Group is already driven by another engine.\n");
+
+	this->completionQueueGroup->progressEngineAttached.store(true);
+	this->acknowledgedSubmissionQueuesVersion.store(0);
+	this->running.store(true);
+	this->thread = std::thread(&ProgressEngine::run, this);
+
+}
+
+void ProgressEngine::stop() {
+
+	if (!this->running.load()) {
+		return;
+	}
+
+	this->running.store(false);
+	this->thread.join();
+	this->completionQueueGroup->progressEngineThread.store(std::thread::id());
+	this->completionQueueGroup->progressEngineAttached.store(false);
+
+}
+
+bool ProgressEngine::isRunning() {
+	return this->running.load();
+}
+
+void ProgressEngine::setReceiveCallback(ReceiveCallback receiveCallback, void* callbackContext) {
+
+	INFINITY_ASSERT(!this->running.load(), "[INFINITY][CORE][PROGRESS] Receive callback cannot be changed while the engine is running.\n");
+
+	this->receiveCallback = receiveCallback;
+	this->callbackContext = callbackContext;
+
+}
+
+void ProgressEngine::addSubmissionQueue(infinity::queues::SubmissionQueue* submissionQueue) {
+
+	std::lock_guard<std::mutex> guard(this->submissionQueuesLock);
+	this->submissionQueues.push_back(submissionQueue);
+	this->submissionQueuesVersion.fetch_add(1, std::memory_order_release);
+
+}
+
+void ProgressEngine::removeSubmissionQueue(infinity::queues::SubmissionQueue* submissionQueue) {
+
+	uint64_t version;
+	{
+		std::lock_guard<std::mutex> guard(this->submissionQueuesLock);
+		this->submissionQueues.erase(std::remove(this->submissionQueues.begin(), this->submissionQueues.end(), submissionQueue),
+				this->submissionQueues.end());
+		version = this->submissionQueuesVersion.fetch_add(1, std::memory_order_release) + 1;
+	}
+
+	// The engine may still be draining the removed queue until it picked up the new list (or exited)
+	while (this->acknowledgedSubmissionQueuesVersion.load(std::memory_order_acquire) < version) {
+		std::this_thread::yield();
+	}
+
+}
+
+CompletionQueueGroup* ProgressEngine::getCompletionQueueGroup() {
+	return this->completionQueueGroup;
+}
+
+void ProgressEngine::run() {
+
+	// Operations posted from this thread have to poll for free send queue slots themselves
+	this->completionQueueGroup->progressEngineThread.store(std::this_thread::get_id());
+
+	bool pinned = (this->core >= 0) ? infinity::utils::Numa::pinThreadToCore(this->core) : this->completionQueueGroup->getContext()->pinThreadToNumaNode();
+	if (!pinned) {
+		INFINITY_DEBUG("[INFINITY][CORE][PROGRESS] Could not pin progress engine thread.\n");
+	}
+
+	std::vector<infinity::queues::SubmissionQueue *> activeSubmissionQueues;
+	uint64_t activeSubmissionQueuesVersion = 0;
+	receive_element_t receiveElements[Configuration::MAX_COMPLETION_BATCH_SIZE];
+	infinity::memory::Buffer *repostedBuffers[Configuration::MAX_COMPLETION_BATCH_SIZE];
+
+	while (this->running.load(std::memory_order_relaxed)) {
+
+		// Pick up added or removed submission queues
+		if (this->submissionQueuesVersion.load(std::memory_order_acquire) != activeSubmissionQueuesVersion) {
+			std::lock_guard<std::mutex> guard(this->submissionQueuesLock);
+			activeSubmissionQueues = this->submissionQueues;
+			activeSubmissionQueuesVersion = this->submissionQueuesVersion.load(std::memory_order_relaxed);
+			this->acknowledgedSubmissionQueuesVersion.store(activeSubmissionQueuesVersion, std::memory_order_release);
+		}
+
+		for (uint32_t i = 0; i < activeSubmissionQueues.size(); ++i) {
+			activeSubmissionQueues[i]->drain();
+		}
+
+		this->completionQueueGroup->pollSendCompletionQueue(Configuration::MAX_COMPLETION_BATCH_SIZE);
+		this->completionQueueGroup->replenishReceiveBuffers();
+
+		if (this->receiveCallback != NULL) {
+			uint32_t numberOfElements = this->completionQueueGroup->receiveBatch(receiveElements, Configuration::MAX_COMPLETION_BATCH_SIZE);
+			uint32_t numberOfRepostedBuffers = 0;
+			for (uint32_t i = 0; i < numberOfElements; ++i) {
+				// Buffers of write-with-immediate completions were already reposted
+				if (this->receiveCallback(&(receiveElements[i]), this->callbackContext) && receiveElements[i].buffer != NULL) {
+					infinity::memory::ReceiveBufferPool *receiveBufferPool = this->completionQueueGroup->receiveBufferPool;
+					if (receiveBufferPool != NULL && receiveBufferPool->ownsBuffer(receiveElements[i].buffer)) {
+						receiveBufferPool->release(receiveElements[i].buffer);
+					} else {
+						repostedBuffers[numberOfRepostedBuffers++] = receiveElements[i].buffer;
+					}
+				}
+			}
+			if (numberOfRepostedBuffers > 0) {
+				this->completionQueueGroup->postReceiveBuffers(repostedBuffers, numberOfRepostedBuffers);
+			}
+		}
+
+	}
+
+	// Operations submitted before the engine was stopped are still posted, queues removed in the meantime are skipped
+	std::lock_guard<std::mutex> guard(this->submissionQueuesLock);
+	for (uint32_t i = 0; i < this->submissionQueues.size(); ++i) {
+		while (this->submissionQueues[i]->drain() > 0 || this->submissionQueues[i]->hasUnpostedWorkRequests()) {
+			this->completionQueueGroup->pollSendCompletionQueue(Configuration::MAX_COMPLETION_BATCH_SIZE);
+		}
+	}
+	this->acknowledgedSubmissionQueuesVersion.store(UINT64_MAX, std::memory_order_release);
+
+}
+
+} /* namespace core */
+} /* namespace infinity */
@@ -0,0 +1,411 @@
+/**
+ * Coroutines - Scheduler
+ *
+ * (c) 2018 Claude Barthels, ETH Zurich
+ * Contact: claudeb@inf.ethz.ch
+ *
+ */
+
+#ifndef COROUTINES_SCHEDULER_H_
+#define COROUTINES_SCHEDULER_H_
+
+#if __cplusplus >= 202002L
+
+#include <coroutine>
+#include <stdint.h>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include <infinity/core/CompletionQueueGroup.h>
+#include <infinity/core/Configuration.h>
+#include <infinity/core/Context.h>
+#include <infinity/coroutines/Task.h>
+#include <infinity/memory/Atomic.h>
+#include <infinity/memory/Buffer.h>
+#include <infinity/memory/RegionToken.h>
+#include <infinity/queues/QueuePair.h>
+#include <infinity/requests/RequestToken.h>
+#include <infinity/utils/Debug.h>
+
+namespace infinity {
+namespace coroutines {
+
+/**
+ * Single-threaded event loop which polls a completion queue group and resumes the tasks whose operations completed
+ * Operations must be issued on queue pairs of this group, the group must not be driven by a progress engine at the same time
+ */
+class Scheduler {
+
+public:
+
+	/**
+	 * Suspends the awaiting task until the posted operation completed, co_await yields true on success
+	 * (and false without suspending if the operation was not posted)
+	 * The request token lives in the coroutine frame, no allocation is done per operation
+	 */
+	template<typename Operation>
+	class OperationAwaitable {
+
+	public:
+
+		OperationAwaitable(Scheduler *scheduler, Operation operation) :
+				scheduler(scheduler), operation(std::move(operation)), requestToken(scheduler->getContext()), posted(false) {
+		}
+
+		OperationAwaitable(const OperationAwaitable &) = delete;
+		OperationAwaitable & operator=(const OperationAwaitable &) = delete;
+
+		/**
+		 * Only destroyed before completion together with the frame of an unfinished task, the device must not write into the token afterwards
+		 */
+		~OperationAwaitable() {
+			if (this->posted && !this->requestToken.checkIfCompleted()) {
+				this->requestToken.clearCompletionCallback();
+				this->requestToken.waitUntilCompleted();
+			}
+		}
+
+		bool await_ready() noexcept {
+			return false;
+		}
+
+		bool await_suspend(std::coroutine_handle<> handle) {
+			this->handle = handle;
+			this->requestToken.setCompletionCallback(&OperationAwaitable::onCompletion, this);
+			// The task continues right away if the operation was not posted
+			this->posted = this->operation(&this->requestToken);
+			return this->posted;
+		}
+
+		bool await_resume() {
+			return this->posted && this->requestToken.wasSuccessful();
+		}
+
+	protected:
+
+		static void onCompletion(infinity::requests::RequestToken *, void *callbackContext) {
+			OperationAwaitable *awaitable = reinterpret_cast<OperationAwaitable *>(callbackContext);
+			awaitable->scheduler->schedule(awaitable->handle);
+		}
+
+		Scheduler * const scheduler;
+		Operation operation;
+		infinity::requests::RequestToken requestToken;
+		std::coroutine_handle<> handle;
+		bool posted;
+
+	};
+
+	/**
+	 * Suspends the awaiting task until a message was received, waiting tasks are served in order
+	 */
+	class ReceiveAwaitable {
+
+		friend class infinity::coroutines::Scheduler;
+
+	public:
+
+		ReceiveAwaitable(Scheduler *scheduler) :
+				scheduler(scheduler), next(nullptr) {
+		}
+
+		ReceiveAwaitable(const ReceiveAwaitable &) = delete;
+		ReceiveAwaitable & operator=(const ReceiveAwaitable &) = delete;
+
+		bool await_ready() {
+			return this->scheduler->receiveWaitersHead == nullptr && this->scheduler->completionQueueGroup->receive(&this->receiveElement);
+		}
+
+		void await_suspend(std::coroutine_handle<> handle) {
+			this->handle = handle;
+			this->scheduler->enqueueReceiveWaiter(this);
+		}
+
+		infinity::core::receive_element_t await_resume() {
+			return this->receiveElement;
+		}
+
+	protected:
+
+		Scheduler * const scheduler;
+		ReceiveAwaitable *next;
+		std::coroutine_handle<> handle;
+		infinity::core::receive_element_t receiveElement;
+
+	};
+
+	/**
+	 * Resumes the awaiting task on the next iteration of the scheduler, lets other tasks run in between
+	 */
+	class YieldAwaitable {
+
+	public:
+
+		YieldAwaitable(Scheduler *scheduler) :
+				scheduler(scheduler) {
+		}
+
+		bool await_ready() noexcept {
+			return false;
+		}
+
+		void await_suspend(std::coroutine_handle<> handle) {
+			this->scheduler->schedule(handle);
+		}
+
+		void await_resume() noexcept {
+		}
+
+	protected:
+
+		Scheduler * const scheduler;
+
+	};
+
+public:
+
+	/**
+	 * Polls the given group (or the default group of the context)
+	 */
+	Scheduler(infinity::core::Context *context) :
+			Scheduler(context->getDefaultCompletionQueueGroup()) {
+	}
+
+	Scheduler(infinity::core::CompletionQueueGroup *completionQueueGroup) :
+			completionQueueGroup(completionQueueGroup), receiveWaitersHead(nullptr), receiveWaitersTail(nullptr),
+			numberOfReceiveWaiters(0) {
+		this->readyHandles.reserve(infinity::core::Configuration::MAX_COMPLETION_BATCH_SIZE);
+		this->resumedHandles.reserve(infinity::core::Configuration::MAX_COMPLETION_BATCH_SIZE);
+	}
+
+	/**
+	 * Tasks which did not finish are destroyed, operations they are suspended on are waited for first
+	 */
+	~Scheduler() {
+		if (!this->activeTasks.empty()) {
+			INFINITY_DEBUG("[INFINITY][COROUTINES][SCHEDULER] Destroying %lu unfinished tasks.\n", this->activeTasks.size());
+		}
+		std::vector<void *> unfinishedTasks(this->activeTasks.begin(), this->activeTasks.end());
+		this->activeTasks.clear();
+		for (uint64_t i = 0; i < unfinishedTasks.size(); ++i) {
+			std::coroutine_handle<>::from_address(unfinishedTasks[i]).destroy();
+		}
+	}
+
+	Scheduler(const Scheduler &) = delete;
+	Scheduler & operator=(const Scheduler &) = delete;
+
+public:
+
+	/**
+	 * Takes ownership of the task, it starts running on the next call to run() or runOnce()
+	 */
+	void spawn(Task task) {
+		std::coroutine_handle<Task::promise_type> handle = task.handle;
+		task.handle = nullptr;
+		handle.promise().finishedCallback = &Scheduler::onTaskFinished;
+		handle.promise().finishedContext = this;
+		this->activeTasks.insert(handle.address());
+		schedule(handle);
+	}
+
+	/**
+	 * Runs until all spawned tasks have finished
+	 */
+	void run() {
+		while (runOnce()) {
+		}
+	}
+
+	/**
+	 * Polls the completion queues once and resumes all tasks which became ready, returns true while tasks are active
+	 */
+	bool runOnce() {
+
+		INFINITY_ASSERT(!this->completionQueueGroup->hasProgressEngine(),
+				"[INFINITY][COROUTINES][SCHEDULER] Completion queue group is driven by a progress engine.\n");
+
+		this->completionQueueGroup->pollSendCompletionQueue(infinity::core::Configuration::MAX_COMPLETION_BATCH_SIZE);
+
+		if (this->numberOfReceiveWaiters > 0) {
+			dispatchReceives();
+		}
+
+		// Tasks resumed here may schedule further tasks, those run on the next iteration
+		this->resumedHandles.swap(this->readyHandles);
+		for (uint64_t i = 0; i < this->resumedHandles.size(); ++i) {
+			this->resumedHandles[i].resume();
+		}
+		this->resumedHandles.clear();
+
+		return !this->activeTasks.empty();
+
+	}
+
+	/**
+	 * Resume the given coroutine on the next iteration
+	 */
+	void schedule(std::coroutine_handle<> handle) {
+		this->readyHandles.push_back(handle);
+	}
+
+public:
+
+	/**
+	 * Awaitable operations, the arguments are forwarded to the corresponding queue pair operation
+	 * Buffers and region tokens must stay valid until the awaiting task was resumed
+	 */
+
+	auto send(infinity::queues::QueuePair *queuePair, infinity::memory::Buffer *buffer) {
+		return makeOperation([queuePair, buffer](infinity::requests::RequestToken *requestToken) {
+			return queuePair->send(buffer, requestToken);
+		});
+	}
+
+	auto send(infinity::queues::QueuePair *queuePair, infinity::memory::Buffer *buffer, uint64_t localOffset, uint32_t sizeInBytes,
+			infinity::queues::OperationFlags flags = infinity::queues::OperationFlags()) {
+		return makeOperation([=](infinity::requests::RequestToken *requestToken) {
+			return queuePair->send(buffer, localOffset, sizeInBytes, flags, requestToken);
+		});
+	}
+
+	auto write(infinity::queues::QueuePair *queuePair, infinity::memory::Buffer *buffer, infinity::memory::RegionToken *destination) {
+		return makeOperation([queuePair, buffer, destination](infinity::requests::RequestToken *requestToken) {
+			return queuePair->write(buffer, destination, requestToken);
+		});
+	}
+
+	auto write(infinity::queues::QueuePair *queuePair, infinity::memory::Buffer *buffer, uint64_t localOffset, infinity::memory::RegionToken *destination,
+			uint64_t remoteOffset, uint32_t sizeInBytes, infinity::queues::OperationFlags flags = infinity::queues::OperationFlags()) {
+		return makeOperation([=](infinity::requests::RequestToken *requestToken) {
+			return queuePair->write(buffer, localOffset, destination, remoteOffset, sizeInBytes, flags, requestToken);
+		});
+	}
+
+	auto writeWithImmediate(infinity::queues::QueuePair *queuePair, infinity::memory::Buffer *buffer, uint64_t localOffset,
+			infinity::memory::RegionToken *destination, uint64_t remoteOffset, uint32_t sizeInBytes, uint32_t immediateValue,
+			infinity::queues::OperationFlags flags = infinity::queues::OperationFlags()) {
+		return makeOperation([=](infinity::requests::RequestToken *requestToken) {
+			return queuePair->writeWithImmediate(buffer, localOffset, destination, remoteOffset, sizeInBytes, immediateValue, flags, requestToken);
+		});
+	}
+
+	auto read(infinity::queues::QueuePair *queuePair, infinity::memory::Buffer *buffer, infinity::memory::RegionToken *source) {
+		return makeOperation([queuePair, buffer, source](infinity::requests::RequestToken *requestToken) {
+			return queuePair->read(buffer, source, requestToken);
+		});
+	}
+
+	auto read(infinity::queues::QueuePair *queuePair, infinity::memory::Buffer *buffer, uint64_t localOffset, infinity::memory::RegionToken *source,
+			uint64_t remoteOffset, uint32_t sizeInBytes, infinity::queues::OperationFlags flags = infinity::queues::OperationFlags()) {
+		return makeOperation([=](infinity::requests::RequestToken *requestToken) {
+			return queuePair->read(buffer, localOffset, source, remoteOffset, sizeInBytes, flags, requestToken);
+		});
+	}
+
+	auto compareAndSwap(infinity::queues::QueuePair *queuePair, infinity::memory::RegionToken *destination, infinity::memory::Atomic *previousValue,
+			uint64_t compare, uint64_t swap, infinity::queues::OperationFlags flags = infinity::queues::OperationFlags()) {
+		return makeOperation([=](infinity::requests::RequestToken *requestToken) {
+			return queuePair->compareAndSwap(destination, previousValue, compare, swap, flags, requestToken);
+		});
+	}
+
+	auto fetchAndAdd(infinity::queues::QueuePair *queuePair, infinity::memory::RegionToken *destination, infinity::memory::Atomic *previousValue,
+			uint64_t add, infinity::queues::OperationFlags flags = infinity::queues::OperationFlags()) {
+		return makeOperation([=](infinity::requests::RequestToken *requestToken) {
+			return queuePair->fetchAndAdd(destination, previousValue, add, flags, requestToken);
+		});
+	}
+
+	/**
+	 * Awaits the next message received on the shared receive queue of the group
+	 */
+	ReceiveAwaitable receive() {
+		return ReceiveAwaitable(this);
+	}
+
+	YieldAwaitable yield() {
+		return YieldAwaitable(this);
+	}
+
+public:
+
+	infinity::core::Context * getContext() {
+		return this->completionQueueGroup->getContext();
+	}
+
+	infinity::core::CompletionQueueGroup * getCompletionQueueGroup() {
+		return this->completionQueueGroup;
+	}
+
+	uint64_t getNumberOfActiveTasks() {
+		return this->activeTasks.size();
+	}
+
+protected:
+
+	template<typename Operation>
+	OperationAwaitable<Operation> makeOperation(Operation operation) {
+		return OperationAwaitable<Operation>(this, std::move(operation));
+	}
+
+	static void onTaskFinished(void *context, void *frame) {
+		reinterpret_cast<Scheduler *>(context)->activeTasks.erase(frame);
+	}
+
+	void enqueueReceiveWaiter(ReceiveAwaitable *receiveAwaitable) {
+		if (this->receiveWaitersTail == nullptr) {
+			this->receiveWaitersHead = receiveAwaitable;
+		} else {
+			this->receiveWaitersTail->next = receiveAwaitable;
+		}
+		this->receiveWaitersTail = receiveAwaitable;
+		++this->numberOfReceiveWaiters;
+	}
+
+	void dispatchReceives() {
+
+		infinity::core::receive_element_t receiveElements[infinity::core::Configuration::MAX_COMPLETION_BATCH_SIZE];
+		uint32_t maxNumberOfElements =
+				(this->numberOfReceiveWaiters < infinity::core::Configuration::MAX_COMPLETION_BATCH_SIZE) ?
+						this->numberOfReceiveWaiters : infinity::core::Configuration::MAX_COMPLETION_BATCH_SIZE;
+
+		uint32_t numberOfElements = this->completionQueueGroup->receiveBatch(receiveElements, maxNumberOfElements);
+		for (uint32_t i = 0; i < numberOfElements; ++i) {
+			ReceiveAwaitable *receiveAwaitable = this->receiveWaitersHead;
+			this->receiveWaitersHead = receiveAwaitable->next;
+			if (this->receiveWaitersHead == nullptr) {
+				this->receiveWaitersTail = nullptr;
+			}
+			--this->numberOfReceiveWaiters;
+			receiveAwaitable->receiveElement = receiveElements[i];
+			schedule(receiveAwaitable->handle);
+		}
+
+	}
+
+protected:
+
+	infinity::core::CompletionQueueGroup * const completionQueueGroup;
+
+	/**
+	 * Frames of spawned tasks which did not finish yet
+	 */
+	std::unordered_set<void *> activeTasks;
+
+	std::vector<std::coroutine_handle<>> readyHandles;
+	std::vector<std::coroutine_handle<>> resumedHandles;
+
+	ReceiveAwaitable *receiveWaitersHead;
+	ReceiveAwaitable *receiveWaitersTail;
+	uint32_t numberOfReceiveWaiters;
+
+};
+
+} /* namespace coroutines */
+} /* namespace infinity */
+
+#endif /* __cplusplus >= 202002L */
+
+#endif /* COROUTINES_SCHEDULER_H_ */
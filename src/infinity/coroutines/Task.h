@@ -0,0 +1,147 @@
+/**
+ * Coroutines - Task
+ *
+ * (c) 2018 Claude Barthels, ETH Zurich
+ * Contact: claudeb@inf.ethz.ch
+ *
+ */
+
+#ifndef COROUTINES_TASK_H_
+#define COROUTINES_TASK_H_
+
+#if __cplusplus >= 202002L
+
+#include <coroutine>
+#include <exception>
+
+namespace infinity {
+namespace coroutines {
+
+class Scheduler;
+
+/**
+ * Lazily started coroutine, either spawned on a scheduler or awaited from another task
+ */
+class Task {
+
+	friend class infinity::coroutines::Scheduler;
+
+public:
+
+	class promise_type {
+
+		friend class infinity::coroutines::Scheduler;
+		friend class infinity::coroutines::Task;
+
+	public:
+
+		Task get_return_object() {
+			return Task(std::coroutine_handle<promise_type>::from_promise(*this));
+		}
+
+		std::suspend_always initial_suspend() noexcept {
+			return {};
+		}
+
+		/**
+		 * Transfers control to the awaiting task, spawned tasks are handed back to their scheduler
+		 */
+		class FinalAwaiter {
+
+		public:
+
+			bool await_ready() noexcept {
+				return false;
+			}
+
+			std::coroutine_handle<> await_suspend(std::coroutine_handle<promise_type> handle) noexcept {
+				promise_type &promise = handle.promise();
+				if (promise.continuation) {
+					return promise.continuation;
+				}
+				// Spawned task, nobody owns the frame anymore
+				void (*finishedCallback)(void *, void *) = promise.finishedCallback;
+				void *finishedContext = promise.finishedContext;
+				void *frame = handle.address();
+				handle.destroy();
+				if (finishedCallback != nullptr) {
+					finishedCallback(finishedContext, frame);
+				}
+				return std::noop_coroutine();
+			}
+
+			void await_resume() noexcept {
+			}
+
+		};
+
+		FinalAwaiter final_suspend() noexcept {
+			return {};
+		}
+
+		void return_void() {
+		}
+
+		void unhandled_exception() {
+			std::terminate();
+		}
+
+	protected:
+
+		std::coroutine_handle<> continuation;
+		void (*finishedCallback)(void *context, void *frame) = nullptr;
+		void *finishedContext = nullptr;
+
+	};
+
+public:
+
+	Task(Task &&other) noexcept :
+			handle(other.handle) {
+		other.handle = nullptr;
+	}
+
+	Task(const Task &) = delete;
+	Task & operator=(const Task &) = delete;
+	Task & operator=(Task &&) = delete;
+
+	~Task() {
+		if (this->handle) {
+			this->handle.destroy();
+		}
+	}
+
+public:
+
+	/**
+	 * Awaiting a task starts it and resumes the caller once it returned
+	 */
+
+	bool await_ready() noexcept {
+		return false;
+	}
+
+	std::coroutine_handle<> await_suspend(std::coroutine_handle<> caller) noexcept {
+		this->handle.promise().continuation = caller;
+		return this->handle;
+	}
+
+	void await_resume() noexcept {
+	}
+
+protected:
+
+	explicit Task(std::coroutine_handle<promise_type> handle) :
+			handle(handle) {
+	}
+
+	std::coroutine_handle<promise_type> handle;
+
+};
+
+} /* namespace coroutines */
+} /* namespace infinity */
+
+#endif /* __cplusplus >= 202002L */
+
+#endif /* COROUTINES_TASK_H_ */
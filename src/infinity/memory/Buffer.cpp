@@ -8,10 +8,11 @@
 
 #include "Buffer.h"
 
-#include <stdlib.h>
 #include <string.h>
 
 #include <infinity/core/Configuration.h>
+#include <infinity/memory/PageAllocator.h>
+#include <infinity/memory/RegistrationCache.h>
 #include <infinity/utils/Debug.h>
 
 #define MIN(a,b) (((a)<(b)) ? (a) : (b))
@@ -19,16 +20,18 @@
 namespace infinity {
 namespace memory {
 
-Buffer::Buffer(infinity::core::Context* context, uint64_t sizeInBytes) {
+Buffer::Buffer(infinity::core::Context* context, uint64_t sizeInBytes) :
+		Buffer(context, sizeInBytes, SMALL_PAGES) {
+
+}
+
+Buffer::Buffer(infinity::core::Context* context, uint64_t sizeInBytes, PageType pageType) {
 
 	this->context = context;
 	this->sizeInBytes = sizeInBytes;
 	this->memoryRegionType = RegionType::BUFFER;
 
-	int res = posix_memalign(&(this->data), infinity::core::Configuration::PAGE_SIZE, sizeInBytes);
-	INFINITY_ASSERT(res == 0, "[INFINITY][MEMORY][BUFFER] Cannot allocate and align buffer.\n");
-
-	memset(this->data, 0, sizeInBytes);
+	this->data = PageAllocator::allocate(sizeInBytes, pageType, &(this->pageType), context->getAllocationNumaNode());
 
 	this->ibvMemoryRegion = ibv_reg_mr(this->context->getProtectionDomain(), this->data, this->sizeInBytes,
 			IBV_ACCESS_REMOTE_WRITE | IBV_ACCESS_LOCAL_WRITE | IBV_ACCESS_REMOTE_READ);
@@ -36,6 +39,8 @@ Buffer::Buffer(infinity::core::Context* context, uint64_t sizeInBytes) {
 
 	this->memoryAllocated = true;
 	this->memoryRegistered = true;
+	this->registrationCache = NULL;
+	this->cachedRegistration = NULL;
 
 }
 
@@ -49,7 +54,10 @@ Buffer::Buffer(infinity::core::Context* context, infinity::memory::RegisteredMem
 	this->ibvMemoryRegion = memory->getRegion();
 
 	this->memoryAllocated = false;
+	this->pageType = memory->getPageType();
 	this->memoryRegistered = false;
+	this->registrationCache = NULL;
+	this->cachedRegistration = NULL;
 
 }
 
@@ -65,7 +73,27 @@ Buffer::Buffer(infinity::core::Context *context, void *memory, uint64_t sizeInBy
 	INFINITY_ASSERT(this->ibvMemoryRegion != NULL, "[INFINITY][MEMORY][BUFFER] Registration failed.\n");
 
 	this->memoryAllocated = false;
+	this->pageType = SMALL_PAGES;
 	this->memoryRegistered = true;
+	this->registrationCache = NULL;
+	this->cachedRegistration = NULL;
+
+}
+
+Buffer::Buffer(infinity::core::Context *context, infinity::memory::RegistrationCache *registrationCache, void *memory, uint64_t sizeInBytes) {
+
+	this->context = context;
+	this->sizeInBytes = sizeInBytes;
+	this->memoryRegionType = RegionType::BUFFER;
+
+	this->data = memory;
+	this->registrationCache = registrationCache;
+	this->cachedRegistration = registrationCache->acquire(memory, sizeInBytes);
+	this->ibvMemoryRegion = this->cachedRegistration->getRegion();
+
+	this->memoryAllocated = false;
+	this->pageType = SMALL_PAGES;
+	this->memoryRegistered = false;
 
 }
 
@@ -75,7 +103,10 @@ Buffer::~Buffer() {
 		ibv_dereg_mr(this->ibvMemoryRegion);
 	}
 	if (this->memoryAllocated) {
-		free(this->data);
+		PageAllocator::release(this->data, this->sizeInBytes, this->pageType);
+	}
+	if (this->registrationCache != NULL) {
+		this->registrationCache->release(this->cachedRegistration);
 	}
 
 }
@@ -84,6 +115,10 @@ void* Buffer::getData() {
 	return reinterpret_cast<void *>(this->getAddress());
 }
 
+PageType Buffer::getPageType() {
+	return this->pageType;
+}
+
 void Buffer::resize(uint64_t newSize, void* newData) {
 
 	void *oldData = this->data;
@@ -10,19 +10,24 @@
 #define MEMORY_BUFFER_H_
 
 #include <infinity/core/Context.h>
+#include <infinity/memory/PageType.h>
 #include <infinity/memory/Region.h>
 #include <infinity/memory/RegisteredMemory.h>
 
 namespace infinity {
 namespace memory {
 
+class RegistrationCache;
+
 class Buffer : public Region {
 
 public:
 
 	Buffer(infinity::core::Context *context, uint64_t sizeInBytes);
+	Buffer(infinity::core::Context *context, uint64_t sizeInBytes, PageType pageType);
 	Buffer(infinity::core::Context *context, infinity::memory::RegisteredMemory *memory, uint64_t offset, uint64_t sizeInBytes);
 	Buffer(infinity::core::Context *context, void *memory, uint64_t sizeInBytes);
+	Buffer(infinity::core::Context *context, infinity::memory::RegistrationCache *registrationCache, void *memory, uint64_t sizeInBytes);
 	~Buffer();
 
 public:
@@ -30,10 +35,19 @@ public:
 	void * getData();
 	void resize(uint64_t newSize, void *newData = NULL);
 
+	/**
+	 * Page type backing the buffer, may be smaller than the requested one if huge pages were not available
+	 */
+	PageType getPageType();
+
 protected:
 
 	bool memoryRegistered;
 	bool memoryAllocated;
+	PageType pageType;
+
+	infinity::memory::RegistrationCache *registrationCache;
+	infinity::memory::RegisteredMemory *cachedRegistration;
 
 
 };
@@ -0,0 +1,185 @@
+/*
+ * Memory - Buffer Pool
+ *
+ * (c) 2018 Claude Barthels, ETH Zurich
+ * Contact: claudeb@inf.ethz.ch
+ *
+ */
+
+#include "BufferPool.h"
+
+#include <atomic>
+
+#include <infinity/utils/Debug.h>
+
+#define MAX(a,b) ((a) > (b) ? (a) : (b))
+#define MIN(a,b) (((a)<(b)) ? (a) : (b))
+
+namespace infinity {
+namespace memory {
+
+typedef struct {
+	uint64_t poolId;
+	void *threadCache;
+} lastUsedThreadCache_t;
+
+// Pool ids are never reused, a stale entry can therefore not match a newer pool
+static std::atomic<uint64_t> nextPoolId(1);
+static thread_local lastUsedThreadCache_t lastUsedThreadCache = {0, NULL};
+
+BufferPool::BufferPool(infinity::core::Context* context, uint64_t arenaSizeInBytes, PageType arenaPageType) :
+		context(context), arenaSizeInBytes(arenaSizeInBytes), arenaPageType(arenaPageType), poolId(nextPoolId.fetch_add(1)) {
+
+	INFINITY_ASSERT(arenaSizeInBytes >= infinity::core::Configuration::BUFFER_POOL_MIN_BUFFER_SIZE,
+			"[INFINITY][MEMORY][POOL] Arena must be larger than the smallest size class.\n");
+
+	this->arenaOffset = 0;
+
+}
+
+BufferPool::~BufferPool() {
+
+	for (std::unordered_map<std::thread::id, ThreadCache *>::iterator it = threadCaches.begin(); it != threadCaches.end(); ++it) {
+		delete it->second;
+	}
+
+	for (uint64_t i = 0; i < allBuffers.size(); ++i) {
+		delete allBuffers[i];
+	}
+
+	for (uint64_t i = 0; i < arenas.size(); ++i) {
+		delete arenas[i];
+	}
+
+}
+
+Buffer* BufferPool::allocate(uint64_t sizeInBytes) {
+
+	uint32_t sizeClass = getSizeClass(sizeInBytes);
+	ThreadCache *threadCache = getThreadCache();
+
+	std::vector<Buffer *> &cachedBuffers = threadCache->buffers[sizeClass];
+	if (cachedBuffers.empty()) {
+		refillThreadCache(threadCache, sizeClass);
+	}
+
+	Buffer *buffer = cachedBuffers.back();
+	cachedBuffers.pop_back();
+	return buffer;
+
+}
+
+void BufferPool::free(Buffer* buffer) {
+
+	uint32_t sizeClass = getSizeClass(buffer->getSizeInBytes());
+	ThreadCache *threadCache = getThreadCache();
+
+	std::vector<Buffer *> &cachedBuffers = threadCache->buffers[sizeClass];
+	cachedBuffers.push_back(buffer);
+	if (cachedBuffers.size() > infinity::core::Configuration::BUFFER_POOL_THREAD_CACHE_SIZE) {
+		flushThreadCache(threadCache, sizeClass);
+	}
+
+}
+
+uint64_t BufferPool::getSizeOfSizeClass(uint64_t sizeInBytes) {
+	return infinity::core::Configuration::BUFFER_POOL_MIN_BUFFER_SIZE << getSizeClass(sizeInBytes);
+}
+
+uint64_t BufferPool::getRegisteredSizeInBytes() {
+
+	std::lock_guard<std::mutex> guard(this->poolLock);
+
+	uint64_t registeredSizeInBytes = 0;
+	for (uint64_t i = 0; i < arenas.size(); ++i) {
+		registeredSizeInBytes += arenas[i]->getSizeInBytes();
+	}
+	return registeredSizeInBytes;
+
+}
+
+uint32_t BufferPool::getSizeClass(uint64_t sizeInBytes) {
+
+	if (sizeInBytes <= infinity::core::Configuration::BUFFER_POOL_MIN_BUFFER_SIZE) {
+		return 0;
+	}
+
+	uint32_t sizeClass = (64 - __builtin_clzll(sizeInBytes - 1)) - (63 - __builtin_clzll(infinity::core::Configuration::BUFFER_POOL_MIN_BUFFER_SIZE));
+	INFINITY_ASSERT(sizeClass < NUMBER_OF_SIZE_CLASSES, "[INFINITY][MEMORY][POOL] Requested buffer size %lu is too large.\n", sizeInBytes);
+	return sizeClass;
+
+}
+
+BufferPool::ThreadCache* BufferPool::getThreadCache() {
+
+	if (lastUsedThreadCache.poolId == this->poolId) {
+		return reinterpret_cast<ThreadCache *>(lastUsedThreadCache.threadCache);
+	}
+
+	std::lock_guard<std::mutex> guard(this->poolLock);
+
+	ThreadCache *threadCache;
+	std::unordered_map<std::thread::id, ThreadCache *>::iterator it = threadCaches.find(std::this_thread::get_id());
+	if (it != threadCaches.end()) {
+		threadCache = it->second;
+	} else {
+		threadCache = new ThreadCache();
+		threadCaches.insert({std::this_thread::get_id(), threadCache});
+	}
+
+	lastUsedThreadCache.poolId = this->poolId;
+	lastUsedThreadCache.threadCache = threadCache;
+
+	return threadCache;
+
+}
+
+void BufferPool::refillThreadCache(ThreadCache* threadCache, uint32_t sizeClass) {
+
+	std::lock_guard<std::mutex> guard(this->poolLock);
+
+	std::vector<Buffer *> &sharedBuffers = this->freeBuffers[sizeClass];
+	if (sharedBuffers.empty()) {
+		carveSlab(sizeClass);
+	}
+
+	uint64_t numberOfBuffers = MIN(sharedBuffers.size(), MAX(infinity::core::Configuration::BUFFER_POOL_THREAD_CACHE_SIZE / 2, 1));
+	threadCache->buffers[sizeClass].insert(threadCache->buffers[sizeClass].end(), sharedBuffers.end() - numberOfBuffers, sharedBuffers.end());
+	sharedBuffers.resize(sharedBuffers.size() - numberOfBuffers);
+
+}
+
+void BufferPool::flushThreadCache(ThreadCache* threadCache, uint32_t sizeClass) {
+
+	std::lock_guard<std::mutex> guard(this->poolLock);
+
+	std::vector<Buffer *> &cachedBuffers = threadCache->buffers[sizeClass];
+	uint64_t numberOfBuffers = cachedBuffers.size() / 2;
+	this->freeBuffers[sizeClass].insert(this->freeBuffers[sizeClass].end(), cachedBuffers.end() - numberOfBuffers, cachedBuffers.end());
+	cachedBuffers.resize(cachedBuffers.size() - numberOfBuffers);
+
+}
+
+void BufferPool::carveSlab(uint32_t sizeClass) {
+
+	uint64_t bufferSizeInBytes = infinity::core::Configuration::BUFFER_POOL_MIN_BUFFER_SIZE << sizeClass;
+	uint64_t slabSizeInBytes = MAX(bufferSizeInBytes, infinity::core::Configuration::BUFFER_POOL_SLAB_SIZE);
+
+	if (arenas.empty() || this->arenaOffset + slabSizeInBytes > arenas.back()->getSizeInBytes()) {
+		arenas.push_back(new RegisteredMemory(this->context, MAX(this->arenaSizeInBytes, slabSizeInBytes), this->arenaPageType));
+		this->arenaOffset = 0;
+		INFINITY_DEBUG("[INFINITY][MEMORY][POOL] Registered new arena of %lu bytes.\n", arenas.back()->getSizeInBytes());
+	}
+
+	for (uint64_t offset = 0; offset < slabSizeInBytes; offset += bufferSizeInBytes) {
+		Buffer *buffer = new Buffer(this->context, arenas.back(), this->arenaOffset + offset, bufferSizeInBytes);
+		this->freeBuffers[sizeClass].push_back(buffer);
+		this->allBuffers.push_back(buffer);
+	}
+
+	this->arenaOffset += slabSizeInBytes;
+
+}
+
+} /* namespace memory */
+} /* namespace infinity */
@@ -0,0 +1,126 @@
+/*
+ * Memory - Page Allocator
+ *
+ * (c) 2018 Claude Barthels, ETH Zurich
+ * Contact: claudeb@inf.ethz.ch
+ *
+ */
+
+#include "PageAllocator.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+
+#include <infinity/core/Configuration.h>
+#include <infinity/utils/Debug.h>
+#include <infinity/utils/Numa.h>
+
+#ifndef MAP_HUGE_SHIFT
+#define MAP_HUGE_SHIFT 26
+#endif
+#ifndef MAP_HUGE_2MB
+#define MAP_HUGE_2MB (21 << MAP_HUGE_SHIFT)
+#endif
+#ifndef MAP_HUGE_1GB
+#define MAP_HUGE_1GB (30 << MAP_HUGE_SHIFT)
+#endif
+
+namespace infinity {
+namespace memory {
+
+static uint64_t roundUp(uint64_t sizeInBytes, uint64_t pageSizeInBytes) {
+	return (sizeInBytes + pageSizeInBytes - 1) & ~(pageSizeInBytes - 1);
+}
+
+static void * mapHugePages(uint64_t sizeInBytes, PageType pageType, int32_t numaNode) {
+
+	uint64_t mappedSizeInBytes = roundUp(sizeInBytes, PageAllocator::getPageSizeInBytes(pageType));
+	int flags = MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | ((pageType == HUGE_PAGES_1GB) ? MAP_HUGE_1GB : MAP_HUGE_2MB);
+	void *data = mmap(NULL, mappedSizeInBytes, PROT_READ | PROT_WRITE, flags, -1, 0);
+	if (data == MAP_FAILED) {
+		return NULL;
+	}
+
+	infinity::utils::Numa::bindMemoryToNode(data, mappedSizeInBytes, numaNode);
+
+	// Fault in the pages now, running out of huge pages later would raise SIGBUS
+	memset(data, 0, sizeInBytes);
+	return data;
+
+}
+
+void * PageAllocator::allocate(uint64_t sizeInBytes, PageType requestedPageType, PageType *obtainedPageType, int32_t numaNode) {
+
+	void *data = NULL;
+
+	if (requestedPageType == HUGE_PAGES_1GB) {
+		data = mapHugePages(sizeInBytes, HUGE_PAGES_1GB, numaNode);
+		if (data != NULL) {
+			*obtainedPageType = HUGE_PAGES_1GB;
+			return data;
+		}
+		INFINITY_DEBUG("[INFINITY][MEMORY][PAGES] No 1 GiB huge pages available, trying 2 MiB huge pages.\n");
+		requestedPageType = HUGE_PAGES_2MB;
+	}
+
+	if (requestedPageType == HUGE_PAGES_2MB) {
+		data = mapHugePages(sizeInBytes, HUGE_PAGES_2MB, numaNode);
+		if (data != NULL) {
+			*obtainedPageType = HUGE_PAGES_2MB;
+			return data;
+		}
+		INFINITY_DEBUG("[INFINITY][MEMORY][PAGES] No 2 MiB huge pages available, trying transparent huge pages.\n");
+		requestedPageType = TRANSPARENT_HUGE_PAGES;
+	}
+
+	if (requestedPageType == TRANSPARENT_HUGE_PAGES) {
+		uint64_t pageSizeInBytes = getPageSizeInBytes(TRANSPARENT_HUGE_PAGES);
+		int res = posix_memalign(&data, pageSizeInBytes, roundUp(sizeInBytes, pageSizeInBytes));
+		INFINITY_ASSERT(res == 0, "[INFINITY][MEMORY][PAGES] Cannot allocate and align memory.\n");
+		if (madvise(data, roundUp(sizeInBytes, pageSizeInBytes), MADV_HUGEPAGE) == 0) {
+			// Advice and placement must be given before the memory is touched
+			infinity::utils::Numa::bindMemoryToNode(data, sizeInBytes, numaNode);
+			memset(data, 0, sizeInBytes);
+			*obtainedPageType = TRANSPARENT_HUGE_PAGES;
+			return data;
+		}
+		INFINITY_DEBUG("[INFINITY][MEMORY][PAGES] Transparent huge pages not supported, using regular pages.\n");
+		free(data);
+	}
+
+	int res = posix_memalign(&data, infinity::core::Configuration::PAGE_SIZE, sizeInBytes);
+	INFINITY_ASSERT(res == 0, "[INFINITY][MEMORY][PAGES] Cannot allocate and align memory.\n");
+	infinity::utils::Numa::bindMemoryToNode(data, sizeInBytes, numaNode);
+	memset(data, 0, sizeInBytes);
+	*obtainedPageType = SMALL_PAGES;
+	return data;
+
+}
+
+void PageAllocator::release(void* data, uint64_t sizeInBytes, PageType pageType) {
+
+	if (pageType == HUGE_PAGES_2MB || pageType == HUGE_PAGES_1GB) {
+		munmap(data, roundUp(sizeInBytes, getPageSizeInBytes(pageType)));
+	} else {
+		free(data);
+	}
+
+}
+
+uint64_t PageAllocator::getPageSizeInBytes(PageType pageType) {
+
+	switch (pageType) {
+		case HUGE_PAGES_1GB:
+			return 1024ull * 1024 * 1024;
+		case HUGE_PAGES_2MB:
+		case TRANSPARENT_HUGE_PAGES:
+			return 2ull * 1024 * 1024;
+		default:
+			return infinity::core::Configuration::PAGE_SIZE;
+	}
+
+}
+
+} /* namespace memory */
+} /* namespace infinity */
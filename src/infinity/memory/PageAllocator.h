@@ -0,0 +1,42 @@
+/*
+ * Memory - Page Allocator
+ *
+ * (c) 2018 Claude Barthels, ETH Zurich
+ * Contact: claudeb@inf.ethz.ch
+ *
+ */
+
+#ifndef MEMORY_PAGEALLOCATOR_H_
+#define MEMORY_PAGEALLOCATOR_H_
+
+#include <stdint.h>
+
+#include <infinity/memory/PageType.h>
+
+namespace infinity {
+namespace memory {
+
+class PageAllocator {
+
+public:
+
+	/**
+	 * Allocates zeroed memory backed by the requested page type, falls back to smaller pages (1 GiB, 2 MiB, transparent huge pages,
+	 * regular pages) if the requested type is not available. The page type which was actually used is returned in obtainedPageType.
+	 * Pages are placed on the given NUMA node if possible (-1 for the node of the calling thread).
+	 */
+	static void * allocate(uint64_t sizeInBytes, PageType requestedPageType, PageType *obtainedPageType, int32_t numaNode = -1);
+
+	/**
+	 * Releases memory obtained from allocate()
+	 */
+	static void release(void *data, uint64_t sizeInBytes, PageType pageType);
+
+	static uint64_t getPageSizeInBytes(PageType pageType);
+
+};
+
+} /* namespace memory */
+} /* namespace infinity */
+
+#endif /* MEMORY_PAGEALLOCATOR_H_ */
@@ -0,0 +1,168 @@
+/*
+ * Memory - Receive Buffer Pool
+ *
+ * (c) 2018 Claude Barthels, ETH Zurich
+ * Contact: claudeb@inf.ethz.ch
+ *
+ */
+
+#include "ReceiveBufferPool.h"
+
+#include <new>
+#include <stdlib.h>
+#include <string.h>
+
+#include <infinity/core/CompletionQueueGroup.h>
+#include <infinity/utils/Debug.h>
+
+#define MAX(a,b) ((a) > (b) ? (a) : (b))
+#define MIN(a,b) (((a)<(b)) ? (a) : (b))
+
+namespace infinity {
+namespace memory {
+
+ReceiveBufferPool::ReceiveBufferPool(infinity::core::CompletionQueueGroup* completionQueueGroup, uint32_t numberOfBuffers, uint64_t bufferSizeInBytes,
+		uint32_t lowWatermark) :
+		completionQueueGroup(completionQueueGroup), numberOfBuffers(numberOfBuffers), bufferSizeInBytes(bufferSizeInBytes) {
+
+	INFINITY_ASSERT(numberOfBuffers > 0, "[INFINITY][MEMORY][RECEIVEPOOL] Pool must hold at least one buffer.\n");
+	INFINITY_ASSERT(completionQueueGroup->receiveBufferPool == NULL,
+			"[INFINITY][MEMORY][RECEIVEPOOL] Completion queue group already has a receive buffer pool.\n");
+
+	infinity::core::Context *context = completionQueueGroup->getContext();
+
+	this->targetDepth = MIN(numberOfBuffers, context->getConfiguration()->sharedReceiveQueueLength);
+	this->lowWatermark = (lowWatermark == 0) ? MAX(this->targetDepth / 4, 1) : MIN(lowWatermark, this->targetDepth);
+
+	// Carve all buffers from one registration
+	this->arena = new RegisteredMemory(context, numberOfBuffers * bufferSizeInBytes);
+
+	void *memory;
+	int returnValue = posix_memalign(&memory, infinity::core::Configuration::CACHE_LINE_SIZE, numberOfBuffers * sizeof(Buffer));
+	INFINITY_ASSERT(returnValue == 0, "[INFINITY][MEMORY][RECEIVEPOOL] Cannot allocate buffer descriptors.\n");
+	this->buffers = reinterpret_cast<Buffer *>(memory);
+	this->entries = new entry_t[numberOfBuffers];
+
+	for (uint32_t i = 0; i < numberOfBuffers; ++i) {
+		::new (&(this->buffers[i])) Buffer(context, this->arena, i * bufferSizeInBytes, bufferSizeInBytes);
+		this->entries[i].next = (i + 1 < numberOfBuffers) ? &(this->entries[i + 1]) : NULL;
+	}
+
+	this->freeEntries = &(this->entries[0]);
+	this->replenishing.clear();
+	this->releasedEntries.store(NULL);
+	this->numberOfPostedBuffers.store(0);
+
+	// Attach first, completions of the initial buffers must already be accounted
+	completionQueueGroup->receiveBufferPool = this;
+	replenish();
+	armLimitEvent();
+
+	INFINITY_DEBUG("[INFINITY][MEMORY][RECEIVEPOOL] Posted %u of %u buffers of %lu bytes (low watermark %u).\n", this->numberOfPostedBuffers.load(),
+			numberOfBuffers, bufferSizeInBytes, this->lowWatermark);
+
+}
+
+ReceiveBufferPool::~ReceiveBufferPool() {
+
+	for (uint32_t i = 0; i < this->numberOfBuffers; ++i) {
+		this->buffers[i].~Buffer();
+	}
+	free(this->buffers);
+	delete[] this->entries;
+	delete this->arena;
+
+}
+
+void ReceiveBufferPool::release(Buffer* buffer) {
+
+	INFINITY_ASSERT(ownsBuffer(buffer), "[INFINITY][MEMORY][RECEIVEPOOL] Released buffer was not taken from this pool.\n");
+
+	entry_t *entry = &(this->entries[buffer - this->buffers]);
+	entry_t *head = this->releasedEntries.load(std::memory_order_relaxed);
+	do {
+		entry->next = head;
+	} while (!this->releasedEntries.compare_exchange_weak(head, entry, std::memory_order_release, std::memory_order_relaxed));
+
+	// An empty shared receive queue produces no completions which would trigger a refill
+	if (needsReplenishment()) {
+		replenish();
+	}
+
+}
+
+uint32_t ReceiveBufferPool::replenish() {
+
+	if (this->replenishing.test_and_set(std::memory_order_acquire)) {
+		return 0;
+	}
+
+	Buffer *postBuffers[infinity::core::Configuration::MAX_COMPLETION_BATCH_SIZE];
+	uint32_t numberOfPostedBuffers = 0;
+
+	while (this->numberOfPostedBuffers.load(std::memory_order_relaxed) < this->targetDepth) {
+
+		if (this->freeEntries == NULL) {
+			this->freeEntries = this->releasedEntries.exchange(NULL, std::memory_order_acquire);
+			if (this->freeEntries == NULL) {
+				break;
+			}
+		}
+
+		uint32_t missingBuffers = this->targetDepth - this->numberOfPostedBuffers.load(std::memory_order_relaxed);
+		uint32_t batchSize = MIN(missingBuffers, infinity::core::Configuration::MAX_COMPLETION_BATCH_SIZE);
+		uint32_t numberOfBuffersInBatch = 0;
+		while (numberOfBuffersInBatch < batchSize && this->freeEntries != NULL) {
+			postBuffers[numberOfBuffersInBatch++] = &(this->buffers[this->freeEntries - this->entries]);
+			this->freeEntries = this->freeEntries->next;
+		}
+
+		// Count before posting, the completions may be processed by another thread right away
+		this->numberOfPostedBuffers.fetch_add(numberOfBuffersInBatch, std::memory_order_relaxed);
+		this->completionQueueGroup->postReceiveBuffers(postBuffers, numberOfBuffersInBatch);
+		numberOfPostedBuffers += numberOfBuffersInBatch;
+
+	}
+
+	this->replenishing.clear(std::memory_order_release);
+
+	return numberOfPostedBuffers;
+
+}
+
+uint32_t ReceiveBufferPool::getNumberOfBuffers() {
+	return this->numberOfBuffers;
+}
+
+uint32_t ReceiveBufferPool::getNumberOfPostedBuffers() {
+	return this->numberOfPostedBuffers.load();
+}
+
+uint32_t ReceiveBufferPool::getTargetDepth() {
+	return this->targetDepth;
+}
+
+uint32_t ReceiveBufferPool::getLowWatermark() {
+	return this->lowWatermark;
+}
+
+uint64_t ReceiveBufferPool::getBufferSizeInBytes() {
+	return this->bufferSizeInBytes;
+}
+
+void ReceiveBufferPool::armLimitEvent() {
+
+	ibv_srq_attr srqAttributes;
+	memset(&srqAttributes, 0, sizeof(ibv_srq_attr));
+	srqAttributes.srq_limit = this->lowWatermark;
+
+	// Not every device supports SRQ limits, the receiving thread still refills the queue
+	int returnValue = ibv_modify_srq(this->completionQueueGroup->getSharedReceiveQueue(), &srqAttributes, IBV_SRQ_LIMIT);
+	if (returnValue != 0) {
+		INFINITY_DEBUG("[INFINITY][MEMORY][RECEIVEPOOL] Could not arm shared receive queue limit (error %d).\n", returnValue);
+	}
+
+}
+
+} /* namespace memory */
+} /* namespace infinity */
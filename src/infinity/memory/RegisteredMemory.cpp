@@ -8,25 +8,25 @@
 
 #include "RegisteredMemory.h"
 
-#include <stdlib.h>
-#include <string.h>
-
 #include <infinity/core/Configuration.h>
+#include <infinity/memory/PageAllocator.h>
 #include <infinity/utils/Debug.h>
 
 namespace infinity {
 namespace memory {
 
-RegisteredMemory::RegisteredMemory(infinity::core::Context* context, uint64_t sizeInBytes) {
+RegisteredMemory::RegisteredMemory(infinity::core::Context* context, uint64_t sizeInBytes) :
+		RegisteredMemory(context, sizeInBytes, SMALL_PAGES) {
+
+}
+
+RegisteredMemory::RegisteredMemory(infinity::core::Context* context, uint64_t sizeInBytes, PageType pageType) {
 
 	this->context = context;
 	this->sizeInBytes = sizeInBytes;
 	this->memoryAllocated = true;
 
-	int res = posix_memalign(&(this->data), infinity::core::Configuration::PAGE_SIZE, sizeInBytes);
-	INFINITY_ASSERT(res == 0, "[INFINITY][MEMORY][REGISTERED] Cannot allocate and align buffer.\n");
-
-	memset(this->data, 0, sizeInBytes);
+	this->data = PageAllocator::allocate(sizeInBytes, pageType, &(this->pageType), context->getAllocationNumaNode());
 
 	this->ibvMemoryRegion = ibv_reg_mr(this->context->getProtectionDomain(), this->data, this->sizeInBytes,
 			IBV_ACCESS_REMOTE_WRITE | IBV_ACCESS_LOCAL_WRITE | IBV_ACCESS_REMOTE_READ);
@@ -38,6 +38,7 @@ RegisteredMemory::RegisteredMemory(infinity::core::Context* context, void *data,
 	this->context = context;
 	this->sizeInBytes = sizeInBytes;
 	this->memoryAllocated = false;
+	this->pageType = SMALL_PAGES;
 
 	this->data = data;
 
@@ -52,7 +53,7 @@ RegisteredMemory::~RegisteredMemory() {
 	ibv_dereg_mr(this->ibvMemoryRegion);
 
 	if(this->memoryAllocated) {
-		free(this->data);
+		PageAllocator::release(this->data, this->sizeInBytes, this->pageType);
 	}
 
 }
@@ -75,5 +76,11 @@ ibv_mr* RegisteredMemory::getRegion() {
 
 }
 
+PageType RegisteredMemory::getPageType() {
+
+	return this->pageType;
+
+}
+
 } /* namespace pool */
 } /* namespace ivory */
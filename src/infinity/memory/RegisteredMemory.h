@@ -10,6 +10,7 @@
 #define INFINITY_MEMORY_REGISTEREDMEMORY_H_
 
 #include <infinity/core/Context.h>
+#include <infinity/memory/PageType.h>
 
 namespace infinity {
 namespace memory {
@@ -19,6 +20,7 @@ class RegisteredMemory {
 public:
 
 	 RegisteredMemory(infinity::core::Context *context, uint64_t sizeInBytes);
+	 RegisteredMemory(infinity::core::Context *context, uint64_t sizeInBytes, PageType pageType);
 	 RegisteredMemory(infinity::core::Context *context, void *data, uint64_t sizeInBytes);
 	 ~RegisteredMemory();
 
@@ -28,6 +30,10 @@ public:
 
 	 ibv_mr * getRegion();
 
+	 /**
+	  * Page type backing the memory, may be smaller than the requested one if huge pages were not available
+	  */
+	 PageType getPageType();
 
 protected:
 
@@ -41,6 +47,7 @@ protected:
 protected:
 
 	 bool memoryAllocated;
+	 PageType pageType;
 
 };
 
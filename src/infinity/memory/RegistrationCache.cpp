@@ -0,0 +1,227 @@
+/*
+ * Memory - Registration Cache
+ *
+ * (c) 2018 Claude Barthels, ETH Zurich
+ * Contact: claudeb@inf.ethz.ch
+ *
+ */
+
+#include "RegistrationCache.h"
+
+#include <vector>
+
+#include <infinity/utils/Debug.h>
+
+namespace infinity {
+namespace memory {
+
+RegistrationCache::RegistrationCache(infinity::core::Context* context, uint64_t maxPinnedSizeInBytes) :
+		context(context), maxPinnedSizeInBytes(maxPinnedSizeInBytes) {
+
+	this->pinnedSizeInBytes = 0;
+	this->maxEntrySizeInBytes = 0;
+	this->numberOfHits = 0;
+	this->numberOfMisses = 0;
+
+}
+
+RegistrationCache::~RegistrationCache() {
+
+	for (std::unordered_map<RegisteredMemory *, entry_t *>::iterator it = entriesByMemory.begin(); it != entriesByMemory.end(); ++it) {
+		delete it->second->memory;
+		delete it->second;
+	}
+
+}
+
+RegisteredMemory* RegistrationCache::acquire(void* data, uint64_t sizeInBytes) {
+
+	std::lock_guard<std::mutex> guard(this->cacheLock);
+
+	uint64_t startAddress = reinterpret_cast<uint64_t>(data);
+	uint64_t endAddress = startAddress + sizeInBytes;
+
+	entry_t *entry = findEntry(startAddress, endAddress);
+	if (entry != NULL) {
+		++this->numberOfHits;
+		if (entry->referenceCount++ == 0) {
+			this->unusedEntries.erase(entry->unusedPosition);
+		}
+		return entry->memory;
+	}
+
+	++this->numberOfMisses;
+
+	// Register whole pages and absorb unused registrations which overlap the new one
+	uint64_t pageSize = infinity::core::Configuration::PAGE_SIZE;
+	startAddress = startAddress & ~(pageSize - 1);
+	endAddress = (endAddress + pageSize - 1) & ~(pageSize - 1);
+
+	std::vector<entry_t *> overlappingEntries;
+	std::multimap<uint64_t, entry_t *>::iterator it = this->entriesByAddress.lower_bound(endAddress);
+	while (it != this->entriesByAddress.begin()) {
+		--it;
+		if (it->first + this->maxEntrySizeInBytes <= startAddress) {
+			break;
+		}
+		if (it->second->endAddress > startAddress && it->second->referenceCount == 0) {
+			overlappingEntries.push_back(it->second);
+		}
+	}
+	for (uint64_t i = 0; i < overlappingEntries.size(); ++i) {
+		startAddress = (overlappingEntries[i]->startAddress < startAddress) ? overlappingEntries[i]->startAddress : startAddress;
+		endAddress = (overlappingEntries[i]->endAddress > endAddress) ? overlappingEntries[i]->endAddress : endAddress;
+		removeEntry(overlappingEntries[i]);
+	}
+
+	entry = new entry_t;
+	entry->memory = new RegisteredMemory(this->context, reinterpret_cast<void *>(startAddress), endAddress - startAddress);
+	entry->startAddress = startAddress;
+	entry->endAddress = endAddress;
+	entry->referenceCount = 1;
+	entry->valid = true;
+
+	this->entriesByAddress.insert({startAddress, entry});
+	this->entriesByMemory.insert({entry->memory, entry});
+	this->pinnedSizeInBytes += endAddress - startAddress;
+	if (endAddress - startAddress > this->maxEntrySizeInBytes) {
+		this->maxEntrySizeInBytes = endAddress - startAddress;
+	}
+
+	INFINITY_DEBUG("[INFINITY][MEMORY][CACHE] Registered %lu bytes at 0x%lx (%lu bytes pinned).\n", endAddress - startAddress, startAddress,
+			this->pinnedSizeInBytes);
+
+	evictUnusedEntries();
+
+	return entry->memory;
+
+}
+
+void RegistrationCache::release(RegisteredMemory* memory) {
+
+	std::lock_guard<std::mutex> guard(this->cacheLock);
+
+	std::unordered_map<RegisteredMemory *, entry_t *>::iterator it = this->entriesByMemory.find(memory);
+	INFINITY_ASSERT(it != this->entriesByMemory.end(), "[INFINITY][MEMORY][CACHE] Released memory was not acquired from this cache.\n");
+
+	entry_t *entry = it->second;
+	if (--entry->referenceCount > 0) {
+		return;
+	}
+
+	if (!entry->valid) {
+		removeEntry(entry);
+		return;
+	}
+
+	this->unusedEntries.push_front(entry);
+	entry->unusedPosition = this->unusedEntries.begin();
+	evictUnusedEntries();
+
+}
+
+void RegistrationCache::invalidate(void* data, uint64_t sizeInBytes) {
+
+	std::lock_guard<std::mutex> guard(this->cacheLock);
+
+	uint64_t startAddress = reinterpret_cast<uint64_t>(data);
+	uint64_t endAddress = startAddress + sizeInBytes;
+
+	std::vector<entry_t *> overlappingEntries;
+	std::multimap<uint64_t, entry_t *>::iterator it = this->entriesByAddress.lower_bound(endAddress);
+	while (it != this->entriesByAddress.begin()) {
+		--it;
+		if (it->first + this->maxEntrySizeInBytes <= startAddress) {
+			break;
+		}
+		if (it->second->endAddress > startAddress) {
+			overlappingEntries.push_back(it->second);
+		}
+	}
+
+	for (uint64_t i = 0; i < overlappingEntries.size(); ++i) {
+		entry_t *entry = overlappingEntries[i];
+		if (entry->referenceCount == 0) {
+			removeEntry(entry);
+		} else {
+			// Still in use, deregistered on the last release
+			std::pair<std::multimap<uint64_t, entry_t *>::iterator, std::multimap<uint64_t, entry_t *>::iterator> range =
+					this->entriesByAddress.equal_range(entry->startAddress);
+			for (std::multimap<uint64_t, entry_t *>::iterator position = range.first; position != range.second; ++position) {
+				if (position->second == entry) {
+					this->entriesByAddress.erase(position);
+					break;
+				}
+			}
+			entry->valid = false;
+		}
+	}
+
+}
+
+uint64_t RegistrationCache::getPinnedSizeInBytes() {
+	std::lock_guard<std::mutex> guard(this->cacheLock);
+	return this->pinnedSizeInBytes;
+}
+
+uint64_t RegistrationCache::getNumberOfHits() {
+	std::lock_guard<std::mutex> guard(this->cacheLock);
+	return this->numberOfHits;
+}
+
+uint64_t RegistrationCache::getNumberOfMisses() {
+	std::lock_guard<std::mutex> guard(this->cacheLock);
+	return this->numberOfMisses;
+}
+
+RegistrationCache::entry_t* RegistrationCache::findEntry(uint64_t startAddress, uint64_t endAddress) {
+
+	std::multimap<uint64_t, entry_t *>::iterator it = this->entriesByAddress.upper_bound(startAddress);
+	while (it != this->entriesByAddress.begin()) {
+		--it;
+		if (it->first + this->maxEntrySizeInBytes < endAddress) {
+			break;
+		}
+		if (it->second->endAddress >= endAddress) {
+			return it->second;
+		}
+	}
+
+	return NULL;
+
+}
+
+void RegistrationCache::removeEntry(entry_t* entry) {
+
+	if (entry->valid) {
+		std::pair<std::multimap<uint64_t, entry_t *>::iterator, std::multimap<uint64_t, entry_t *>::iterator> range =
+				this->entriesByAddress.equal_range(entry->startAddress);
+		for (std::multimap<uint64_t, entry_t *>::iterator position = range.first; position != range.second; ++position) {
+			if (position->second == entry) {
+				this->entriesByAddress.erase(position);
+				break;
+			}
+		}
+		if (entry->referenceCount == 0) {
+			this->unusedEntries.erase(entry->unusedPosition);
+		}
+	}
+
+	this->entriesByMemory.erase(entry->memory);
+	this->pinnedSizeInBytes -= entry->endAddress - entry->startAddress;
+
+	delete entry->memory;
+	delete entry;
+
+}
+
+void RegistrationCache::evictUnusedEntries() {
+
+	while (this->pinnedSizeInBytes > this->maxPinnedSizeInBytes && !this->unusedEntries.empty()) {
+		removeEntry(this->unusedEntries.back());
+	}
+
+}
+
+} /* namespace memory */
+} /* namespace infinity */
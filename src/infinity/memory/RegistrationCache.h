@@ -0,0 +1,96 @@
+/*
+ * Memory - Registration Cache
+ *
+ * (c) 2018 Claude Barthels, ETH Zurich
+ * Contact: claudeb@inf.ethz.ch
+ *
+ */
+
+#ifndef MEMORY_REGISTRATIONCACHE_H_
+#define MEMORY_REGISTRATIONCACHE_H_
+
+#include <stdint.h>
+#include <list>
+#include <map>
+#include <mutex>
+#include <unordered_map>
+
+#include <infinity/core/Configuration.h>
+#include <infinity/core/Context.h>
+#include <infinity/memory/RegisteredMemory.h>
+
+namespace infinity {
+namespace memory {
+
+/**
+ * Keeps user memory registered across uses, unused registrations are evicted in LRU order once the pinned budget is exceeded
+ */
+class RegistrationCache {
+
+public:
+
+	RegistrationCache(infinity::core::Context *context,
+			uint64_t maxPinnedSizeInBytes = infinity::core::Configuration::REGISTRATION_CACHE_MAX_PINNED_SIZE);
+	~RegistrationCache();
+
+public:
+
+	/**
+	 * Returns a registration covering the given range, registers the surrounding pages on a miss
+	 */
+	RegisteredMemory * acquire(void *data, uint64_t sizeInBytes);
+
+	/**
+	 * Returns a registration obtained from acquire()
+	 */
+	void release(RegisteredMemory *memory);
+
+	/**
+	 * Drops registrations overlapping the given range, must be called before that memory is freed or unmapped
+	 */
+	void invalidate(void *data, uint64_t sizeInBytes);
+
+public:
+
+	uint64_t getPinnedSizeInBytes();
+	uint64_t getNumberOfHits();
+	uint64_t getNumberOfMisses();
+
+protected:
+
+	typedef struct entry {
+		RegisteredMemory *memory;
+		uint64_t startAddress;
+		uint64_t endAddress;
+		uint32_t referenceCount;
+		bool valid;
+		std::list<struct entry *>::iterator unusedPosition;
+	} entry_t;
+
+	entry_t * findEntry(uint64_t startAddress, uint64_t endAddress);
+	void removeEntry(entry_t *entry);
+	void evictUnusedEntries();
+
+protected:
+
+	infinity::core::Context * const context;
+	const uint64_t maxPinnedSizeInBytes;
+
+	std::mutex cacheLock;
+
+	std::multimap<uint64_t, entry_t *> entriesByAddress;
+	std::unordered_map<RegisteredMemory *, entry_t *> entriesByMemory;
+	std::list<entry_t *> unusedEntries;
+
+	uint64_t pinnedSizeInBytes;
+	uint64_t maxEntrySizeInBytes;
+
+	uint64_t numberOfHits;
+	uint64_t numberOfMisses;
+
+};
+
+} /* namespace memory */
+} /* namespace infinity */
+
+#endif /* MEMORY_REGISTRATIONCACHE_H_ */
@@ -0,0 +1,179 @@
+/**
+ * Queues - Flow Controlled Queue Pair
+ *
+ * (c) 2018 Claude Barthels, ETH Zurich
+ * Contact: claudeb@inf.ethz.ch
+ *
+ */
+
+#include "FlowControlledQueuePair.h"
+
+#include <infinity/memory/ReceiveBufferPool.h>
+#include <infinity/utils/Debug.h>
+
+#define MAX(a,b) ((a) > (b) ? (a) : (b))
+
+namespace infinity {
+namespace queues {
+
+FlowControlledQueuePair::FlowControlledQueuePair(QueuePair* queuePair, uint32_t numberOfCredits) :
+		queuePair(queuePair), numberOfCredits(numberOfCredits), creditReturnThreshold(MAX(numberOfCredits / 2, 1)) {
+
+	INFINITY_ASSERT(numberOfCredits > 0 && numberOfCredits < CREDIT_UPDATE_FLAG,
+			"[INFINITY][QUEUES][FLOWCONTROL] Number of credits must be between 1 and %u.\n", CREDIT_UPDATE_FLAG - 1);
+
+	this->availableCredits = numberOfCredits;
+	this->creditsToReturn = 0;
+
+	// All queue pairs of the group share its receive queue, the credits of all of them have to be backed by posted buffers
+	infinity::core::CompletionQueueGroup *completionQueueGroup = queuePair->getCompletionQueueGroup();
+	uint32_t numberOfReservedReceiveBuffers = completionQueueGroup->numberOfReservedReceiveBuffers.fetch_add(getNumberOfRequiredReceiveBuffers())
+			+ getNumberOfRequiredReceiveBuffers();
+	uint32_t numberOfAvailableReceiveBuffers = (completionQueueGroup->getReceiveBufferPool() != NULL) ?
+			completionQueueGroup->getReceiveBufferPool()->getTargetDepth() : completionQueueGroup->getContext()->getConfiguration()->sharedReceiveQueueLength;
+	INFINITY_ASSERT(numberOfReservedReceiveBuffers <= numberOfAvailableReceiveBuffers,
+			"[INFINITY][QUEUES][FLOWCONTROL] Flow controlled queue pairs of the group need %u receive buffers, only %u can be posted.\n",
+			numberOfReservedReceiveBuffers, numberOfAvailableReceiveBuffers);
+	if (numberOfReservedReceiveBuffers > numberOfAvailableReceiveBuffers) {
+		INFINITY_DEBUG("[INFINITY][QUEUES][FLOWCONTROL] Credits exceed the receive buffers of the group, peers may run into RNR retries.\n");
+	}
+
+	this->creditUpdateBuffer = new infinity::memory::Buffer(completionQueueGroup->getContext(), infinity::core::Configuration::CACHE_LINE_SIZE);
+
+	this->numberOfDeferredSends = 0;
+	this->numberOfCreditUpdates = 0;
+
+}
+
+FlowControlledQueuePair::~FlowControlledQueuePair() {
+
+	if (!this->queuedSends.empty()) {
+		INFINITY_DEBUG("[INFINITY][QUEUES][FLOWCONTROL] Dropping %lu queued sends.\n", this->queuedSends.size());
+	}
+
+	delete this->creditUpdateBuffer;
+	this->queuePair->getCompletionQueueGroup()->numberOfReservedReceiveBuffers.fetch_sub(getNumberOfRequiredReceiveBuffers());
+
+}
+
+bool FlowControlledQueuePair::send(infinity::memory::Buffer* buffer, infinity::requests::RequestToken* requestToken) {
+	return send(buffer, 0, buffer->getSizeInBytes(), OperationFlags(), requestToken);
+}
+
+bool FlowControlledQueuePair::send(infinity::memory::Buffer* buffer, uint32_t sizeInBytes, infinity::requests::RequestToken* requestToken) {
+	return send(buffer, 0, sizeInBytes, OperationFlags(), requestToken);
+}
+
+bool FlowControlledQueuePair::send(infinity::memory::Buffer* buffer, uint64_t localOffset, uint32_t sizeInBytes, OperationFlags flags,
+		infinity::requests::RequestToken* requestToken) {
+
+	// Keep the order of messages, sends queued earlier go first
+	if (this->availableCredits > 0 && this->queuedSends.empty()) {
+		postSend(buffer, localOffset, sizeInBytes, flags, requestToken);
+		return true;
+	}
+
+	queued_send_t queuedSend;
+	queuedSend.buffer = buffer;
+	queuedSend.localOffset = localOffset;
+	queuedSend.sizeInBytes = sizeInBytes;
+	queuedSend.flags = flags;
+	queuedSend.requestToken = requestToken;
+	this->queuedSends.push_back(queuedSend);
+	++this->numberOfDeferredSends;
+
+	return false;
+
+}
+
+bool FlowControlledQueuePair::processReceive(infinity::core::receive_element_t* receiveElement) {
+
+	INFINITY_ASSERT(receiveElement->immediateValueValid, "[INFINITY][QUEUES][FLOWCONTROL] Received message does not carry credits.\n");
+
+	bool isCreditUpdate = (receiveElement->immediateValue & CREDIT_UPDATE_FLAG) != 0;
+	this->availableCredits += receiveElement->immediateValue & ~CREDIT_UPDATE_FLAG;
+
+	// Credit updates are sent without credits, the receiver keeps spare buffers for them
+	if (!isCreditUpdate) {
+		++this->creditsToReturn;
+	}
+
+	// Queued sends return credits on their own, an explicit update is only needed if they did not suffice
+	flush();
+	if (this->creditsToReturn >= this->creditReturnThreshold) {
+		sendCreditUpdate();
+	}
+
+	return !isCreditUpdate;
+
+}
+
+uint32_t FlowControlledQueuePair::flush() {
+
+	uint32_t numberOfPostedSends = 0;
+
+	while (this->availableCredits > 0 && !this->queuedSends.empty()) {
+		queued_send_t &queuedSend = this->queuedSends.front();
+		postSend(queuedSend.buffer, queuedSend.localOffset, queuedSend.sizeInBytes, queuedSend.flags, queuedSend.requestToken);
+		this->queuedSends.pop_front();
+		++numberOfPostedSends;
+	}
+
+	return numberOfPostedSends;
+
+}
+
+QueuePair* FlowControlledQueuePair::getQueuePair() {
+	return this->queuePair;
+}
+
+uint32_t FlowControlledQueuePair::getNumberOfCredits() {
+	return this->numberOfCredits;
+}
+
+uint32_t FlowControlledQueuePair::getNumberOfRequiredReceiveBuffers() {
+	// Every update returns at least creditReturnThreshold of the credits, so at most this many are in flight
+	return this->numberOfCredits + this->numberOfCredits / this->creditReturnThreshold;
+}
+
+uint32_t FlowControlledQueuePair::getNumberOfAvailableCredits() {
+	return this->availableCredits;
+}
+
+uint32_t FlowControlledQueuePair::getNumberOfQueuedSends() {
+	return this->queuedSends.size();
+}
+
+uint64_t FlowControlledQueuePair::getNumberOfDeferredSends() {
+	return this->numberOfDeferredSends;
+}
+
+uint64_t FlowControlledQueuePair::getNumberOfCreditUpdates() {
+	return this->numberOfCreditUpdates;
+}
+
+void FlowControlledQueuePair::postSend(infinity::memory::Buffer* buffer, uint64_t localOffset, uint32_t sizeInBytes, OperationFlags flags,
+		infinity::requests::RequestToken* requestToken) {
+
+	--this->availableCredits;
+	uint32_t returnedCredits = this->creditsToReturn;
+	this->creditsToReturn = 0;
+
+	this->queuePair->sendWithImmediate(buffer, localOffset, sizeInBytes, returnedCredits, flags, requestToken);
+
+}
+
+void FlowControlledQueuePair::sendCreditUpdate() {
+
+	uint32_t returnedCredits = this->creditsToReturn;
+	this->creditsToReturn = 0;
+
+	this->queuePair->sendWithImmediate(this->creditUpdateBuffer, 0, 0, returnedCredits | CREDIT_UPDATE_FLAG, OperationFlags(), NULL);
+	++this->numberOfCreditUpdates;
+
+	INFINITY_DEBUG("[INFINITY][QUEUES][FLOWCONTROL] Returned %u credits.\n", returnedCredits);
+
+}
+
+} /* namespace queues */
+} /* namespace infinity */
@@ -12,15 +12,46 @@
 #include <string.h>
 #include <arpa/inet.h>
 #include <cerrno>
+#include <thread>
 
+#include <infinity/core/CompletionQueueGroup.h>
 #include <infinity/core/Configuration.h>
+#include <infinity/queues/WorkRequestBatch.h>
 #include <infinity/utils/Debug.h>
 
-#define MAX(a,b) ((a) > (b) ? (a) : (b))
-
 namespace infinity {
 namespace queues {
 
+/**
+ * Scatter-gather list of a single request, kept on the stack unless it has more elements than the default maximum
+ * (each call owns its list, so queue pairs can be posted to from several threads)
+ */
+class ScatterGatherList {
+
+public:
+
+	ScatterGatherList(uint32_t numberOfElements) {
+		this->elements = this->localElements;
+		if (numberOfElements > infinity::core::Configuration::MAX_NUMBER_OF_SEND_SGE_ELEMENTS) {
+			this->elements = (ibv_sge *) calloc(numberOfElements, sizeof(ibv_sge));
+			INFINITY_ASSERT(this->elements != NULL, "[INFINITY][QUEUES][QUEUEPAIR] Cannot allocate scatter-gather elements.\n");
+		}
+	}
+
+	~ScatterGatherList() {
+		if (this->elements != this->localElements) {
+			free(this->elements);
+		}
+	}
+
+	ibv_sge *elements;
+
+protected:
+
+	ibv_sge localElements[infinity::core::Configuration::MAX_NUMBER_OF_SEND_SGE_ELEMENTS];
+
+};
+
 int OperationFlags::ibvFlags() {
   int flags = 0;
   if (fenced) {
@@ -35,25 +66,57 @@ int OperationFlags::ibvFlags() {
   return flags;
 }
 
-QueuePair::QueuePair(infinity::core::Context* context) :
-		context(context) {
+QueuePair::QueuePair(infinity::core::Context* context, const infinity::core::Configuration *configuration,
+		infinity::core::CompletionQueueGroup *completionQueueGroup) :
+		context(context), completionQueueGroup((completionQueueGroup != NULL) ? completionQueueGroup : context->getDefaultCompletionQueueGroup()),
+		configuration((configuration != NULL) ? *configuration : *(context->getConfiguration())) {
+
+	this->configuration.validate(context->getDeviceAttributes(), context->getPortAttributes());
 
 	ibv_qp_init_attr qpInitAttributes;
 	memset(&qpInitAttributes, 0, sizeof(qpInitAttributes));
 
-	qpInitAttributes.send_cq = context->getSendCompletionQueue();
-	qpInitAttributes.recv_cq = context->getReceiveCompletionQueue();
-	qpInitAttributes.srq = context->getSharedReceiveQueue();
-	qpInitAttributes.cap.max_send_wr = MAX(infinity::core::Configuration::SEND_COMPLETION_QUEUE_LENGTH, 1);
-	qpInitAttributes.cap.max_send_sge = infinity::core::Configuration::MAX_NUMBER_OF_SGE_ELEMENTS;
-	qpInitAttributes.cap.max_recv_wr = MAX(infinity::core::Configuration::RECV_COMPLETION_QUEUE_LENGTH, 1);
-	qpInitAttributes.cap.max_recv_sge = infinity::core::Configuration::MAX_NUMBER_OF_SGE_ELEMENTS;
+	qpInitAttributes.send_cq = this->completionQueueGroup->getSendCompletionQueue();
+	qpInitAttributes.recv_cq = this->completionQueueGroup->getReceiveCompletionQueue();
+	qpInitAttributes.srq = this->completionQueueGroup->getSharedReceiveQueue();
+	if (this->configuration.useNotificationQueue) {
+		INFINITY_ASSERT(this->completionQueueGroup->hasNotificationQueue(),
+				"[INFINITY][QUEUES][QUEUEPAIR] Completion queue group was created without notification queue.\n");
+		qpInitAttributes.srq = this->completionQueueGroup->getNotificationQueue();
+	}
+	qpInitAttributes.cap.max_send_wr = this->configuration.sendQueueLength;
+	qpInitAttributes.cap.max_send_sge = this->configuration.maxNumberOfSendSgeElements;
+	qpInitAttributes.cap.max_recv_wr = this->configuration.receiveQueueLength;
+	qpInitAttributes.cap.max_recv_sge = this->configuration.maxNumberOfReceiveSgeElements;
+	qpInitAttributes.cap.max_inline_data = this->configuration.maxInlineDataSize;
 	qpInitAttributes.qp_type = IBV_QPT_RC;
 	qpInitAttributes.sq_sig_all = 0;
 
 	this->ibvQueuePair = ibv_create_qp(context->getProtectionDomain(), &(qpInitAttributes));
+
+	// Some providers reject an inline size they cannot support instead of reducing it
+	while (this->ibvQueuePair == NULL && qpInitAttributes.cap.max_inline_data > 0) {
+		qpInitAttributes.cap.max_inline_data /= 2;
+		this->ibvQueuePair = ibv_create_qp(context->getProtectionDomain(), &(qpInitAttributes));
+	}
 	INFINITY_ASSERT(this->ibvQueuePair != NULL, "[INFINITY][QUEUES][QUEUEPAIR] Cannot create queue pair.\n");
 
+	this->maxInlineDataSize = qpInitAttributes.cap.max_inline_data;
+
+	this->maxNumberOfReadSgeElements = this->configuration.maxNumberOfSendSgeElements;
+	if (context->getDeviceAttributes()->max_sge_rd > 0 && this->maxNumberOfReadSgeElements > (uint32_t) context->getDeviceAttributes()->max_sge_rd) {
+		this->maxNumberOfReadSgeElements = context->getDeviceAttributes()->max_sge_rd;
+	}
+	this->inlineThreshold = this->maxInlineDataSize;
+
+	this->sendQueueLength = qpInitAttributes.cap.max_send_wr;
+	this->signalingInterval = this->configuration.signalingInterval;
+	this->unsignaledWorkRequests = 0;
+	this->outstandingWorkRequests.store(0);
+	this->signaledWorkRequests = (uint32_t *) calloc(this->sendQueueLength, sizeof(uint32_t));
+	this->signaledWorkRequestsHead.store(0);
+	this->signaledWorkRequestsTail.store(0);
+
 	ibv_qp_attr qpAttributes;
 	memset(&qpAttributes, 0, sizeof(qpAttributes));
 
@@ -70,12 +133,17 @@ QueuePair::QueuePair(infinity::core::Context* context) :
         std::uniform_int_distribution<int> range(0, 1<<24);
         this->sequenceNumber = range(randomGenerator);
 
+	this->maxOutstandingReadAtomicOperations = 0;
+
 	this->userData = NULL;
 	this->userDataSize = 0;
+	this->userContext = NULL;
 }
 
 QueuePair::~QueuePair() {
 
+	this->completionQueueGroup->unregisterQueuePair(this);
+
 	int32_t returnValue = ibv_destroy_qp(this->ibvQueuePair);
 	INFINITY_ASSERT(returnValue == 0, "[INFINITY][QUEUES][QUEUEPAIR] Cannot delete queue pair.\n");
 
@@ -84,19 +152,22 @@ QueuePair::~QueuePair() {
 		this->userDataSize = 0;
 	}
 
+	free(this->signaledWorkRequests);
+
 }
 
-void QueuePair::activate(uint16_t remoteDeviceId, uint32_t remoteQueuePairNumber, uint32_t remoteSequenceNumber) {
+void QueuePair::activate(uint16_t remoteDeviceId, uint32_t remoteQueuePairNumber, uint32_t remoteSequenceNumber, uint8_t maxReadAtomic,
+		uint8_t maxDestinationReadAtomic) {
 
 	ibv_qp_attr qpAttributes;
 	memset(&(qpAttributes), 0, sizeof(qpAttributes));
 
 	qpAttributes.qp_state = IBV_QPS_RTR;
-	qpAttributes.path_mtu = IBV_MTU_4096;
+	qpAttributes.path_mtu = this->configuration.pathMtu;
 	qpAttributes.dest_qp_num = remoteQueuePairNumber;
 	qpAttributes.rq_psn = remoteSequenceNumber;
-	qpAttributes.max_dest_rd_atomic = 1;
-	qpAttributes.min_rnr_timer = 12;
+	qpAttributes.max_dest_rd_atomic = maxDestinationReadAtomic;
+	qpAttributes.min_rnr_timer = this->configuration.minRnrTimer;
 	qpAttributes.ah_attr.is_global = 0;
 	qpAttributes.ah_attr.dlid = remoteDeviceId;
 	qpAttributes.ah_attr.sl = 0;
@@ -109,17 +180,19 @@ void QueuePair::activate(uint16_t remoteDeviceId, uint32_t remoteQueuePairNumber
 	INFINITY_ASSERT(returnValue == 0, "[INFINITY][QUEUES][QUEUEPAIR] Cannot transition to RTR state.\n");
 
 	qpAttributes.qp_state = IBV_QPS_RTS;
-	qpAttributes.timeout = 14;
-	qpAttributes.retry_cnt = 7;
-	qpAttributes.rnr_retry = 7;
+	qpAttributes.timeout = this->configuration.timeout;
+	qpAttributes.retry_cnt = this->configuration.retryCount;
+	qpAttributes.rnr_retry = this->configuration.rnrRetryCount;
 	qpAttributes.sq_psn = this->getSequenceNumber();
-	qpAttributes.max_rd_atomic = 1;
+	qpAttributes.max_rd_atomic = maxReadAtomic;
 
 	returnValue = ibv_modify_qp(this->ibvQueuePair, &qpAttributes,
 			IBV_QP_STATE | IBV_QP_TIMEOUT | IBV_QP_RETRY_CNT | IBV_QP_RNR_RETRY | IBV_QP_SQ_PSN | IBV_QP_MAX_QP_RD_ATOMIC);
 
 	INFINITY_ASSERT(returnValue == 0, "[INFINITY][QUEUES][QUEUEPAIR] Cannot transition to RTS state.\n");
 
+	this->maxOutstandingReadAtomicOperations = maxReadAtomic;
+
 }
 
 void QueuePair::setRemoteUserData(void* userData, uint32_t userDataSize) {
@@ -142,15 +215,23 @@ uint32_t QueuePair::getSequenceNumber() {
 	return this->sequenceNumber;
 }
 
-void QueuePair::send(infinity::memory::Buffer* buffer, infinity::requests::RequestToken *requestToken) {
-	send(buffer, 0, buffer->getSizeInBytes(), OperationFlags(), requestToken);
+infinity::core::CompletionQueueGroup* QueuePair::getCompletionQueueGroup() {
+	return this->completionQueueGroup;
 }
 
-void QueuePair::send(infinity::memory::Buffer* buffer, uint32_t sizeInBytes, infinity::requests::RequestToken *requestToken) {
-	send(buffer, 0, sizeInBytes, OperationFlags(), requestToken);
+uint8_t QueuePair::getMaxOutstandingReadAtomicOperations() {
+	return this->maxOutstandingReadAtomicOperations;
 }
 
-void QueuePair::send(infinity::memory::Buffer* buffer, uint64_t localOffset, uint32_t sizeInBytes, OperationFlags send_flags,
+bool QueuePair::send(infinity::memory::Buffer* buffer, infinity::requests::RequestToken *requestToken) {
+	return send(buffer, 0, buffer->getSizeInBytes(), OperationFlags(), requestToken);
+}
+
+bool QueuePair::send(infinity::memory::Buffer* buffer, uint32_t sizeInBytes, infinity::requests::RequestToken *requestToken) {
+	return send(buffer, 0, sizeInBytes, OperationFlags(), requestToken);
+}
+
+bool QueuePair::send(infinity::memory::Buffer* buffer, uint64_t localOffset, uint32_t sizeInBytes, OperationFlags send_flags,
     infinity::requests::RequestToken *requestToken) {
 
 	if (requestToken != NULL) {
@@ -160,7 +241,6 @@ void QueuePair::send(infinity::memory::Buffer* buffer, uint64_t localOffset, uin
 
 	struct ibv_sge sgElement;
 	struct ibv_send_wr workRequest;
-	struct ibv_send_wr *badWorkRequest;
 
 	memset(&sgElement, 0, sizeof(ibv_sge));
 	sgElement.addr = buffer->getAddress() + localOffset;
@@ -180,15 +260,20 @@ void QueuePair::send(infinity::memory::Buffer* buffer, uint64_t localOffset, uin
 		workRequest.send_flags |= IBV_SEND_SIGNALED;
 	}
 
-	int returnValue = ibv_post_send(this->ibvQueuePair, &workRequest, &badWorkRequest);
+	int returnValue = postWorkRequests(&workRequest, 1, send_flags.nonBlocking);
+	if (returnValue == EBUSY) {
+		return false;
+	}
 
-	INFINITY_ASSERT(returnValue == 0, "[INFINITY][QUEUES][QUEUEPAIR] Posting send request failed. %s.\n", strerror(errno));
+	INFINITY_ASSERT(returnValue == 0, "[INFINITY][QUEUES][QUEUEPAIR] Posting send request failed. %s.\n", strerror(returnValue));
 
 	INFINITY_DEBUG("[INFINITY][QUEUES][QUEUEPAIR] Send request created (id %lu).\n", workRequest.wr_id);
 
+	return (returnValue == 0);
+
 }
 
-void QueuePair::sendWithImmediate(infinity::memory::Buffer* buffer, uint64_t localOffset, uint32_t sizeInBytes, uint32_t immediateValue,
+bool QueuePair::sendWithImmediate(infinity::memory::Buffer* buffer, uint64_t localOffset, uint32_t sizeInBytes, uint32_t immediateValue,
     OperationFlags send_flags, infinity::requests::RequestToken* requestToken) {
 
 	if (requestToken != NULL) {
@@ -199,7 +284,6 @@ void QueuePair::sendWithImmediate(infinity::memory::Buffer* buffer, uint64_t loc
 
 	struct ibv_sge sgElement;
 	struct ibv_send_wr workRequest;
-	struct ibv_send_wr *badWorkRequest;
 
 	memset(&sgElement, 0, sizeof(ibv_sge));
 	sgElement.addr = buffer->getAddress() + localOffset;
@@ -220,25 +304,30 @@ void QueuePair::sendWithImmediate(infinity::memory::Buffer* buffer, uint64_t loc
 		workRequest.send_flags |= IBV_SEND_SIGNALED;
 	}
 
-	int returnValue = ibv_post_send(this->ibvQueuePair, &workRequest, &badWorkRequest);
+	int returnValue = postWorkRequests(&workRequest, 1, send_flags.nonBlocking);
+	if (returnValue == EBUSY) {
+		return false;
+	}
 
-	INFINITY_ASSERT(returnValue == 0, "[INFINITY][QUEUES][QUEUEPAIR] Posting send request failed. %s.\n", strerror(errno));
+	INFINITY_ASSERT(returnValue == 0, "[INFINITY][QUEUES][QUEUEPAIR] Posting send request failed. %s.\n", strerror(returnValue));
 
 	INFINITY_DEBUG("[INFINITY][QUEUES][QUEUEPAIR] Send request created (id %lu).\n", workRequest.wr_id);
 
+	return (returnValue == 0);
+
 }
 
-void QueuePair::write(infinity::memory::Buffer* buffer, infinity::memory::RegionToken* destination, infinity::requests::RequestToken *requestToken) {
-	write(buffer, 0, destination, 0, buffer->getSizeInBytes(), OperationFlags(), requestToken);
+bool QueuePair::write(infinity::memory::Buffer* buffer, infinity::memory::RegionToken* destination, infinity::requests::RequestToken *requestToken) {
 	INFINITY_ASSERT(buffer->getSizeInBytes() <= ((uint64_t) UINT32_MAX), "[INFINITY][QUEUES][QUEUEPAIR] Request must be smaller or equal to UINT_32_MAX bytes. This memory region is larger. Please explicitly indicate the size of the data to transfer.\n");
+	return write(buffer, 0, destination, 0, buffer->getSizeInBytes(), OperationFlags(), requestToken);
 }
 
-void QueuePair::write(infinity::memory::Buffer* buffer, infinity::memory::RegionToken* destination, uint32_t sizeInBytes,
+bool QueuePair::write(infinity::memory::Buffer* buffer, infinity::memory::RegionToken* destination, uint32_t sizeInBytes,
 		infinity::requests::RequestToken *requestToken) {
-	write(buffer, 0, destination, 0, sizeInBytes, OperationFlags(), requestToken);
+	return write(buffer, 0, destination, 0, sizeInBytes, OperationFlags(), requestToken);
 }
 
-void QueuePair::write(infinity::memory::Buffer* buffer, uint64_t localOffset, infinity::memory::RegionToken* destination, uint64_t remoteOffset,
+bool QueuePair::write(infinity::memory::Buffer* buffer, uint64_t localOffset, infinity::memory::RegionToken* destination, uint64_t remoteOffset,
 		uint32_t sizeInBytes, OperationFlags send_flags, infinity::requests::RequestToken *requestToken) {
 
 	if (requestToken != NULL) {
@@ -248,7 +337,6 @@ void QueuePair::write(infinity::memory::Buffer* buffer, uint64_t localOffset, in
 
 	struct ibv_sge sgElement;
 	struct ibv_send_wr workRequest;
-	struct ibv_send_wr *badWorkRequest;
 
 	memset(&sgElement, 0, sizeof(ibv_sge));
 	sgElement.addr = buffer->getAddress() + localOffset;
@@ -273,15 +361,20 @@ void QueuePair::write(infinity::memory::Buffer* buffer, uint64_t localOffset, in
 	INFINITY_ASSERT(sizeInBytes <= destination->getRemainingSizeInBytes(remoteOffset),
 			"[INFINITY][QUEUES][QUEUEPAIR] Segmentation fault while writing to remote memory.\n");
 
-	int returnValue = ibv_post_send(this->ibvQueuePair, &workRequest, &badWorkRequest);
+	int returnValue = postWorkRequests(&workRequest, 1, send_flags.nonBlocking);
+	if (returnValue == EBUSY) {
+		return false;
+	}
 
-	INFINITY_ASSERT(returnValue == 0, "[INFINITY][QUEUES][QUEUEPAIR] Posting write request failed. %s.\n", strerror(errno));
+	INFINITY_ASSERT(returnValue == 0, "[INFINITY][QUEUES][QUEUEPAIR] Posting write request failed. %s.\n", strerror(returnValue));
 
 	INFINITY_DEBUG("[INFINITY][QUEUES][QUEUEPAIR] Write request created (id %lu).\n", workRequest.wr_id);
 
+	return (returnValue == 0);
+
 }
 
-void QueuePair::writeWithImmediate(infinity::memory::Buffer* buffer, uint64_t localOffset, infinity::memory::RegionToken* destination, uint64_t remoteOffset,
+bool QueuePair::writeWithImmediate(infinity::memory::Buffer* buffer, uint64_t localOffset, infinity::memory::RegionToken* destination, uint64_t remoteOffset,
 		uint32_t sizeInBytes, uint32_t immediateValue, OperationFlags send_flags, infinity::requests::RequestToken* requestToken) {
 
 	if (requestToken != NULL) {
@@ -292,7 +385,6 @@ void QueuePair::writeWithImmediate(infinity::memory::Buffer* buffer, uint64_t lo
 
 	struct ibv_sge sgElement;
 	struct ibv_send_wr workRequest;
-	struct ibv_send_wr *badWorkRequest;
 
 	memset(&sgElement, 0, sizeof(ibv_sge));
 	sgElement.addr = buffer->getAddress() + localOffset;
@@ -318,15 +410,20 @@ void QueuePair::writeWithImmediate(infinity::memory::Buffer* buffer, uint64_t lo
 	INFINITY_ASSERT(sizeInBytes <= destination->getRemainingSizeInBytes(remoteOffset),
 			"[INFINITY][QUEUES][QUEUEPAIR] Segmentation fault while writing to remote memory.\n");
 
-	int returnValue = ibv_post_send(this->ibvQueuePair, &workRequest, &badWorkRequest);
+	int returnValue = postWorkRequests(&workRequest, 1, send_flags.nonBlocking);
+	if (returnValue == EBUSY) {
+		return false;
+	}
 
-	INFINITY_ASSERT(returnValue == 0, "[INFINITY][QUEUES][QUEUEPAIR] Posting write request failed. %s.\n", strerror(errno));
+	INFINITY_ASSERT(returnValue == 0, "[INFINITY][QUEUES][QUEUEPAIR] Posting write request failed. %s.\n", strerror(returnValue));
 
 	INFINITY_DEBUG("[INFINITY][QUEUES][QUEUEPAIR] Write request created (id %lu).\n", workRequest.wr_id);
 
+	return (returnValue == 0);
+
 }
 
-void QueuePair::multiWrite(infinity::memory::Buffer** buffers, uint32_t* sizesInBytes, uint64_t* localOffsets, uint32_t numberOfElements,
+bool QueuePair::multiWrite(infinity::memory::Buffer** buffers, uint32_t* sizesInBytes, uint64_t* localOffsets, uint32_t numberOfElements,
 		infinity::memory::RegionToken* destination, uint64_t remoteOffset, OperationFlags send_flags, infinity::requests::RequestToken* requestToken) {
 
 	if (requestToken != NULL) {
@@ -334,31 +431,16 @@ void QueuePair::multiWrite(infinity::memory::Buffer** buffers, uint32_t* sizesIn
 		requestToken->setRegion(buffers[0]);
 	}
 
-	struct ibv_sge *sgElements = (ibv_sge *) calloc(numberOfElements, sizeof(ibv_sge));
 	struct ibv_send_wr workRequest;
-	struct ibv_send_wr *badWorkRequest;
 
-	INFINITY_ASSERT(numberOfElements <= infinity::core::Configuration::MAX_NUMBER_OF_SGE_ELEMENTS, "[INFINITY][QUEUES][QUEUEPAIR] Request contains too many SGE.\n");
+	INFINITY_ASSERT(numberOfElements <= this->configuration.maxNumberOfSendSgeElements, "[INFINITY][QUEUES][QUEUEPAIR] Request contains too many SGE.\n");
 
-	uint32_t totalSizeInBytes = 0;
-	for (uint32_t i = 0; i < numberOfElements; ++i) {
-		if (localOffsets != NULL) {
-			sgElements[i].addr = buffers[i]->getAddress() + localOffsets[i];
-		} else {
-			sgElements[i].addr = buffers[i]->getAddress();
-		}
-		if (sizesInBytes != NULL) {
-			sgElements[i].length = sizesInBytes[i];
-		} else {
-			sgElements[i].length = buffers[i]->getSizeInBytes();
-		}
-		totalSizeInBytes += sgElements[i].length;
-		sgElements[i].lkey = buffers[i]->getLocalKey();
-	}
+	ScatterGatherList sgList(numberOfElements);
+	uint64_t totalSizeInBytes = fillScatterGatherElements(sgList.elements, buffers, sizesInBytes, localOffsets, numberOfElements);
 
 	memset(&workRequest, 0, sizeof(ibv_send_wr));
 	workRequest.wr_id = reinterpret_cast<uint64_t>(requestToken);
-	workRequest.sg_list = sgElements;
+	workRequest.sg_list = sgList.elements;
 	workRequest.num_sge = numberOfElements;
 	workRequest.opcode = IBV_WR_RDMA_WRITE;
 	workRequest.send_flags = send_flags.ibvFlags();
@@ -371,14 +453,20 @@ void QueuePair::multiWrite(infinity::memory::Buffer** buffers, uint32_t* sizesIn
 	INFINITY_ASSERT(totalSizeInBytes <= destination->getRemainingSizeInBytes(remoteOffset),
 			"[INFINITY][QUEUES][QUEUEPAIR] Segmentation fault while writing to remote memory.\n");
 
-	int returnValue = ibv_post_send(this->ibvQueuePair, &workRequest, &badWorkRequest);
+	int returnValue = postWorkRequests(&workRequest, 1, send_flags.nonBlocking);
+	if (returnValue == EBUSY) {
+		return false;
+	}
 
-	INFINITY_ASSERT(returnValue == 0, "[INFINITY][QUEUES][QUEUEPAIR] Posting write request failed. %s.\n", strerror(errno));
+	INFINITY_ASSERT(returnValue == 0, "[INFINITY][QUEUES][QUEUEPAIR] Posting write request failed. %s.\n", strerror(returnValue));
 
 	INFINITY_DEBUG("[INFINITY][QUEUES][QUEUEPAIR] Multi-Write request created (id %lu).\n", workRequest.wr_id);
+
+	return (returnValue == 0);
+
 }
 
-void QueuePair::multiWriteWithImmediate(infinity::memory::Buffer** buffers, uint32_t* sizesInBytes, uint64_t* localOffsets, uint32_t numberOfElements,
+bool QueuePair::multiWriteWithImmediate(infinity::memory::Buffer** buffers, uint32_t* sizesInBytes, uint64_t* localOffsets, uint32_t numberOfElements,
 		infinity::memory::RegionToken* destination, uint64_t remoteOffset, uint32_t immediateValue, OperationFlags send_flags, infinity::requests::RequestToken* requestToken) {
 
 	if (requestToken != NULL) {
@@ -387,31 +475,16 @@ void QueuePair::multiWriteWithImmediate(infinity::memory::Buffer** buffers, uint
 		requestToken->setImmediateValue(immediateValue);
 	}
 
-	struct ibv_sge *sgElements = (ibv_sge *) calloc(numberOfElements, sizeof(ibv_sge));
 	struct ibv_send_wr workRequest;
-	struct ibv_send_wr *badWorkRequest;
 
-	INFINITY_ASSERT(numberOfElements <= infinity::core::Configuration::MAX_NUMBER_OF_SGE_ELEMENTS, "[INFINITY][QUEUES][QUEUEPAIR] Request contains too many SGE.\n");
+	INFINITY_ASSERT(numberOfElements <= this->configuration.maxNumberOfSendSgeElements, "[INFINITY][QUEUES][QUEUEPAIR] Request contains too many SGE.\n");
 
-	uint32_t totalSizeInBytes = 0;
-	for (uint32_t i = 0; i < numberOfElements; ++i) {
-		if (localOffsets != NULL) {
-			sgElements[i].addr = buffers[i]->getAddress() + localOffsets[i];
-		} else {
-			sgElements[i].addr = buffers[i]->getAddress();
-		}
-		if (sizesInBytes != NULL) {
-			sgElements[i].length = sizesInBytes[i];
-		} else {
-			sgElements[i].length = buffers[i]->getSizeInBytes();
-		}
-		totalSizeInBytes += sgElements[i].length;
-		sgElements[i].lkey = buffers[i]->getLocalKey();
-	}
+	ScatterGatherList sgList(numberOfElements);
+	uint64_t totalSizeInBytes = fillScatterGatherElements(sgList.elements, buffers, sizesInBytes, localOffsets, numberOfElements);
 
 	memset(&workRequest, 0, sizeof(ibv_send_wr));
 	workRequest.wr_id = reinterpret_cast<uint64_t>(requestToken);
-	workRequest.sg_list = sgElements;
+	workRequest.sg_list = sgList.elements;
 	workRequest.num_sge = numberOfElements;
 	workRequest.opcode = IBV_WR_RDMA_WRITE_WITH_IMM;
 	workRequest.imm_data = htonl(immediateValue);
@@ -425,25 +498,173 @@ void QueuePair::multiWriteWithImmediate(infinity::memory::Buffer** buffers, uint
 	INFINITY_ASSERT(totalSizeInBytes <= destination->getRemainingSizeInBytes(remoteOffset),
 			"[INFINITY][QUEUES][QUEUEPAIR] Segmentation fault while writing to remote memory.\n");
 
-	int returnValue = ibv_post_send(this->ibvQueuePair, &workRequest, &badWorkRequest);
+	int returnValue = postWorkRequests(&workRequest, 1, send_flags.nonBlocking);
+	if (returnValue == EBUSY) {
+		return false;
+	}
 
-	INFINITY_ASSERT(returnValue == 0, "[INFINITY][QUEUES][QUEUEPAIR] Posting write request failed. %s.\n", strerror(errno));
+	INFINITY_ASSERT(returnValue == 0, "[INFINITY][QUEUES][QUEUEPAIR] Posting write request failed. %s.\n", strerror(returnValue));
 
 	INFINITY_DEBUG("[INFINITY][QUEUES][QUEUEPAIR] Multi-Write request created (id %lu).\n", workRequest.wr_id);
 
+	return (returnValue == 0);
+
+}
+
+bool QueuePair::multiSend(infinity::memory::Buffer** buffers, uint32_t* sizesInBytes, uint64_t* localOffsets, uint32_t numberOfElements,
+		OperationFlags send_flags, infinity::requests::RequestToken* requestToken) {
+
+	if (requestToken != NULL) {
+		requestToken->reset();
+		requestToken->setRegion(buffers[0]);
+	}
+
+	struct ibv_send_wr workRequest;
+
+	INFINITY_ASSERT(numberOfElements <= this->configuration.maxNumberOfSendSgeElements, "[INFINITY][QUEUES][QUEUEPAIR] Request contains too many SGE.\n");
+
+	ScatterGatherList sgList(numberOfElements);
+	fillScatterGatherElements(sgList.elements, buffers, sizesInBytes, localOffsets, numberOfElements);
+
+	memset(&workRequest, 0, sizeof(ibv_send_wr));
+	workRequest.wr_id = reinterpret_cast<uint64_t>(requestToken);
+	workRequest.sg_list = sgList.elements;
+	workRequest.num_sge = numberOfElements;
+	workRequest.opcode = IBV_WR_SEND;
+	workRequest.send_flags = send_flags.ibvFlags();
+	if (requestToken != NULL) {
+		workRequest.send_flags |= IBV_SEND_SIGNALED;
+	}
+
+	int returnValue = postWorkRequests(&workRequest, 1, send_flags.nonBlocking);
+	if (returnValue == EBUSY) {
+		return false;
+	}
+
+	INFINITY_ASSERT(returnValue == 0, "[INFINITY][QUEUES][QUEUEPAIR] Posting send request failed. %s.\n", strerror(returnValue));
+
+	INFINITY_DEBUG("[INFINITY][QUEUES][QUEUEPAIR] Multi-Send request created (id %lu).\n", workRequest.wr_id);
+
+	return (returnValue == 0);
+
+}
+
+bool QueuePair::multiSendWithImmediate(infinity::memory::Buffer** buffers, uint32_t* sizesInBytes, uint64_t* localOffsets, uint32_t numberOfElements,
+		uint32_t immediateValue, OperationFlags send_flags, infinity::requests::RequestToken* requestToken) {
+
+	if (requestToken != NULL) {
+		requestToken->reset();
+		requestToken->setRegion(buffers[0]);
+		requestToken->setImmediateValue(immediateValue);
+	}
+
+	struct ibv_send_wr workRequest;
+
+	INFINITY_ASSERT(numberOfElements <= this->configuration.maxNumberOfSendSgeElements, "[INFINITY][QUEUES][QUEUEPAIR] Request contains too many SGE.\n");
+
+	ScatterGatherList sgList(numberOfElements);
+	fillScatterGatherElements(sgList.elements, buffers, sizesInBytes, localOffsets, numberOfElements);
+
+	memset(&workRequest, 0, sizeof(ibv_send_wr));
+	workRequest.wr_id = reinterpret_cast<uint64_t>(requestToken);
+	workRequest.sg_list = sgList.elements;
+	workRequest.num_sge = numberOfElements;
+	workRequest.opcode = IBV_WR_SEND_WITH_IMM;
+	workRequest.imm_data = htonl(immediateValue);
+	workRequest.send_flags = send_flags.ibvFlags();
+	if (requestToken != NULL) {
+		workRequest.send_flags |= IBV_SEND_SIGNALED;
+	}
+
+	int returnValue = postWorkRequests(&workRequest, 1, send_flags.nonBlocking);
+	if (returnValue == EBUSY) {
+		return false;
+	}
+
+	INFINITY_ASSERT(returnValue == 0, "[INFINITY][QUEUES][QUEUEPAIR] Posting send request failed. %s.\n", strerror(returnValue));
+
+	INFINITY_DEBUG("[INFINITY][QUEUES][QUEUEPAIR] Multi-Send request created (id %lu).\n", workRequest.wr_id);
+
+	return (returnValue == 0);
+
+}
+
+bool QueuePair::multiRead(infinity::memory::Buffer** buffers, uint32_t* sizesInBytes, uint64_t* localOffsets, uint32_t numberOfElements,
+		infinity::memory::RegionToken* source, uint64_t remoteOffset, OperationFlags send_flags, infinity::requests::RequestToken* requestToken) {
+
+	if (requestToken != NULL) {
+		requestToken->reset();
+		requestToken->setRegion(buffers[0]);
+	}
+
+	struct ibv_send_wr workRequest;
+
+	INFINITY_ASSERT(numberOfElements <= this->maxNumberOfReadSgeElements, "[INFINITY][QUEUES][QUEUEPAIR] Request contains too many SGE.\n");
+
+	ScatterGatherList sgList(numberOfElements);
+	uint64_t totalSizeInBytes = fillScatterGatherElements(sgList.elements, buffers, sizesInBytes, localOffsets, numberOfElements);
+
+	memset(&workRequest, 0, sizeof(ibv_send_wr));
+	workRequest.wr_id = reinterpret_cast<uint64_t>(requestToken);
+	workRequest.sg_list = sgList.elements;
+	workRequest.num_sge = numberOfElements;
+	workRequest.opcode = IBV_WR_RDMA_READ;
+	workRequest.send_flags = send_flags.ibvFlags();
+	if (requestToken != NULL) {
+		workRequest.send_flags |= IBV_SEND_SIGNALED;
+	}
+	workRequest.wr.rdma.remote_addr = source->getAddress() + remoteOffset;
+	workRequest.wr.rdma.rkey = source->getRemoteKey();
+
+	INFINITY_ASSERT(totalSizeInBytes <= source->getRemainingSizeInBytes(remoteOffset),
+			"[INFINITY][QUEUES][QUEUEPAIR] Segmentation fault while reading from remote memory.\n");
+
+	int returnValue = postWorkRequests(&workRequest, 1, send_flags.nonBlocking);
+	if (returnValue == EBUSY) {
+		return false;
+	}
+
+	INFINITY_ASSERT(returnValue == 0, "[INFINITY][QUEUES][QUEUEPAIR] Posting read request failed. %s.\n", strerror(returnValue));
+
+	INFINITY_DEBUG("[INFINITY][QUEUES][QUEUEPAIR] Multi-Read request created (id %lu).\n", workRequest.wr_id);
+
+	return (returnValue == 0);
+
+}
+
+uint64_t QueuePair::fillScatterGatherElements(ibv_sge *sgElements, infinity::memory::Buffer** buffers, uint32_t* sizesInBytes, uint64_t* localOffsets,
+		uint32_t numberOfElements) {
+
+	uint64_t totalSizeInBytes = 0;
+	for (uint32_t i = 0; i < numberOfElements; ++i) {
+		uint64_t localOffset = (localOffsets != NULL) ? localOffsets[i] : 0;
+		sgElements[i].addr = buffers[i]->getAddress() + localOffset;
+		if (sizesInBytes != NULL) {
+			sgElements[i].length = sizesInBytes[i];
+		} else {
+			sgElements[i].length = buffers[i]->getRemainingSizeInBytes(localOffset);
+		}
+		sgElements[i].lkey = buffers[i]->getLocalKey();
+		totalSizeInBytes += sgElements[i].length;
+
+		INFINITY_ASSERT(sgElements[i].length <= buffers[i]->getRemainingSizeInBytes(localOffset),
+				"[INFINITY][QUEUES][QUEUEPAIR] Segmentation fault while creating scatter-getter element.\n");
+	}
+	return totalSizeInBytes;
+
 }
 
-void QueuePair::read(infinity::memory::Buffer* buffer, infinity::memory::RegionToken* source, infinity::requests::RequestToken *requestToken) {
-	read(buffer, 0, source, 0, buffer->getSizeInBytes(), OperationFlags(), requestToken);
+bool QueuePair::read(infinity::memory::Buffer* buffer, infinity::memory::RegionToken* source, infinity::requests::RequestToken *requestToken) {
 	INFINITY_ASSERT(buffer->getSizeInBytes() <= ((uint64_t) UINT32_MAX), "[INFINITY][QUEUES][QUEUEPAIR] Request must be smaller or equal to UINT_32_MAX bytes. This memory region is larger. Please explicitly indicate the size of the data to transfer.\n");
+	return read(buffer, 0, source, 0, buffer->getSizeInBytes(), OperationFlags(), requestToken);
 }
 
-void QueuePair::read(infinity::memory::Buffer* buffer, infinity::memory::RegionToken* source, uint32_t sizeInBytes,
+bool QueuePair::read(infinity::memory::Buffer* buffer, infinity::memory::RegionToken* source, uint32_t sizeInBytes,
 		infinity::requests::RequestToken *requestToken) {
-	read(buffer, 0, source, 0, sizeInBytes, OperationFlags(), requestToken);
+	return read(buffer, 0, source, 0, sizeInBytes, OperationFlags(), requestToken);
 }
 
-void QueuePair::read(infinity::memory::Buffer* buffer, uint64_t localOffset, infinity::memory::RegionToken* source, uint64_t remoteOffset, uint32_t sizeInBytes,
+bool QueuePair::read(infinity::memory::Buffer* buffer, uint64_t localOffset, infinity::memory::RegionToken* source, uint64_t remoteOffset, uint32_t sizeInBytes,
 		OperationFlags send_flags, infinity::requests::RequestToken *requestToken) {
 
 	if (requestToken != NULL) {
@@ -453,7 +674,6 @@ void QueuePair::read(infinity::memory::Buffer* buffer, uint64_t localOffset, inf
 
 	struct ibv_sge sgElement;
 	struct ibv_send_wr workRequest;
-	struct ibv_send_wr *badWorkRequest;
 
 	memset(&sgElement, 0, sizeof(ibv_sge));
 	sgElement.addr = buffer->getAddress() + localOffset;
@@ -478,15 +698,104 @@ void QueuePair::read(infinity::memory::Buffer* buffer, uint64_t localOffset, inf
 	INFINITY_ASSERT(sizeInBytes <= source->getRemainingSizeInBytes(remoteOffset),
 			"[INFINITY][QUEUES][QUEUEPAIR] Segmentation fault while reading from remote memory.\n");
 
-	int returnValue = ibv_post_send(this->ibvQueuePair, &workRequest, &badWorkRequest);
+	int returnValue = postWorkRequests(&workRequest, 1, send_flags.nonBlocking);
+	if (returnValue == EBUSY) {
+		return false;
+	}
 
-	INFINITY_ASSERT(returnValue == 0, "[INFINITY][QUEUES][QUEUEPAIR] Posting read request failed. %s.\n", strerror(errno));
+	INFINITY_ASSERT(returnValue == 0, "[INFINITY][QUEUES][QUEUEPAIR] Posting read request failed. %s.\n", strerror(returnValue));
 
 	INFINITY_DEBUG("[INFINITY][QUEUES][QUEUEPAIR] Read request created (id %lu).\n", workRequest.wr_id);
 
+	return (returnValue == 0);
+
+}
+
+bool QueuePair::sendInline(const void* data, uint32_t sizeInBytes, infinity::requests::RequestToken* requestToken) {
+
+	INFINITY_ASSERT(sizeInBytes <= this->maxInlineDataSize,
+			"[INFINITY][QUEUES][QUEUEPAIR] Inlined request of %u bytes exceeds inline capacity of %u bytes.\n", sizeInBytes, this->maxInlineDataSize);
+
+	if (requestToken != NULL) {
+		requestToken->reset();
+	}
+
+	struct ibv_sge sgElement;
+	struct ibv_send_wr workRequest;
+
+	memset(&sgElement, 0, sizeof(ibv_sge));
+	sgElement.addr = reinterpret_cast<uint64_t>(data);
+	sgElement.length = sizeInBytes;
+
+	memset(&workRequest, 0, sizeof(ibv_send_wr));
+	workRequest.wr_id = reinterpret_cast<uint64_t>(requestToken);
+	workRequest.sg_list = &sgElement;
+	workRequest.num_sge = 1;
+	workRequest.opcode = IBV_WR_SEND;
+	workRequest.send_flags = IBV_SEND_INLINE;
+	if (requestToken != NULL) {
+		workRequest.send_flags |= IBV_SEND_SIGNALED;
+	}
+
+	int returnValue = postWorkRequests(&workRequest, 1, false);
+	if (returnValue == EBUSY) {
+		return false;
+	}
+
+	INFINITY_ASSERT(returnValue == 0, "[INFINITY][QUEUES][QUEUEPAIR] Posting inlined send request failed. %s.\n", strerror(returnValue));
+
+	INFINITY_DEBUG("[INFINITY][QUEUES][QUEUEPAIR] Inlined send request created (id %lu).\n", workRequest.wr_id);
+
+	return (returnValue == 0);
+
+}
+
+bool QueuePair::writeInline(const void* data, uint32_t sizeInBytes, infinity::memory::RegionToken* destination, uint64_t remoteOffset,
+		infinity::requests::RequestToken* requestToken) {
+
+	INFINITY_ASSERT(sizeInBytes <= this->maxInlineDataSize,
+			"[INFINITY][QUEUES][QUEUEPAIR] Inlined request of %u bytes exceeds inline capacity of %u bytes.\n", sizeInBytes, this->maxInlineDataSize);
+
+	if (requestToken != NULL) {
+		requestToken->reset();
+	}
+
+	struct ibv_sge sgElement;
+	struct ibv_send_wr workRequest;
+
+	memset(&sgElement, 0, sizeof(ibv_sge));
+	sgElement.addr = reinterpret_cast<uint64_t>(data);
+	sgElement.length = sizeInBytes;
+
+	memset(&workRequest, 0, sizeof(ibv_send_wr));
+	workRequest.wr_id = reinterpret_cast<uint64_t>(requestToken);
+	workRequest.sg_list = &sgElement;
+	workRequest.num_sge = 1;
+	workRequest.opcode = IBV_WR_RDMA_WRITE;
+	workRequest.send_flags = IBV_SEND_INLINE;
+	if (requestToken != NULL) {
+		workRequest.send_flags |= IBV_SEND_SIGNALED;
+	}
+	workRequest.wr.rdma.remote_addr = destination->getAddress() + remoteOffset;
+	workRequest.wr.rdma.rkey = destination->getRemoteKey();
+
+	INFINITY_ASSERT(sizeInBytes <= destination->getRemainingSizeInBytes(remoteOffset),
+			"[INFINITY][QUEUES][QUEUEPAIR] Segmentation fault while writing to remote memory.\n");
+
+	int returnValue = postWorkRequests(&workRequest, 1, false);
+	if (returnValue == EBUSY) {
+		return false;
+	}
+
+	INFINITY_ASSERT(returnValue == 0, "[INFINITY][QUEUES][QUEUEPAIR] Posting inlined write request failed. %s.\n", strerror(returnValue));
+
+	INFINITY_DEBUG("[INFINITY][QUEUES][QUEUEPAIR] Inlined write request created (id %lu).\n", workRequest.wr_id);
+
+	return (returnValue == 0);
+
 }
 
-void QueuePair::compareAndSwap(infinity::memory::RegionToken* destination, infinity::memory::Atomic* previousValue, uint64_t compare, uint64_t swap,
+bool QueuePair::compareAndSwap(infinity::memory::RegionToken* destination, infinity::memory::Atomic* previousValue, uint64_t compare, uint64_t swap,
 		OperationFlags send_flags, infinity::requests::RequestToken *requestToken) {
 
 	if (requestToken != NULL) {
@@ -496,7 +805,6 @@ void QueuePair::compareAndSwap(infinity::memory::RegionToken* destination, infin
 
 	struct ibv_sge sgElement;
 	struct ibv_send_wr workRequest;
-	struct ibv_send_wr *badWorkRequest;
 
 	memset(&sgElement, 0, sizeof(ibv_sge));
 	sgElement.addr = previousValue->getAddress();
@@ -517,23 +825,28 @@ void QueuePair::compareAndSwap(infinity::memory::RegionToken* destination, infin
 	workRequest.wr.atomic.compare_add = compare;
 	workRequest.wr.atomic.swap = swap;
 
-	int returnValue = ibv_post_send(this->ibvQueuePair, &workRequest, &badWorkRequest);
+	int returnValue = postWorkRequests(&workRequest, 1, send_flags.nonBlocking);
+	if (returnValue == EBUSY) {
+		return false;
+	}
 
-	INFINITY_ASSERT(returnValue == 0, "[INFINITY][QUEUES][QUEUEPAIR] Posting cmp-and-swp request failed. %s.\n", strerror(errno));
+	INFINITY_ASSERT(returnValue == 0, "[INFINITY][QUEUES][QUEUEPAIR] Posting cmp-and-swp request failed. %s.\n", strerror(returnValue));
 
 	INFINITY_DEBUG("[INFINITY][QUEUES][QUEUEPAIR] Cmp-and-swp request created (id %lu).\n", workRequest.wr_id);
 
+	return (returnValue == 0);
+
 }
 
-void QueuePair::compareAndSwap(infinity::memory::RegionToken* destination, uint64_t compare, uint64_t swap, infinity::requests::RequestToken *requestToken) {
-	compareAndSwap(destination, context->defaultAtomic, compare, swap, OperationFlags(), requestToken);
+bool QueuePair::compareAndSwap(infinity::memory::RegionToken* destination, uint64_t compare, uint64_t swap, infinity::requests::RequestToken *requestToken) {
+	return compareAndSwap(destination, context->defaultAtomic, compare, swap, OperationFlags(), requestToken);
 }
 
-void QueuePair::fetchAndAdd(infinity::memory::RegionToken* destination, uint64_t add, infinity::requests::RequestToken *requestToken) {
-	fetchAndAdd(destination, context->defaultAtomic, add, OperationFlags(), requestToken);
+bool QueuePair::fetchAndAdd(infinity::memory::RegionToken* destination, uint64_t add, infinity::requests::RequestToken *requestToken) {
+	return fetchAndAdd(destination, context->defaultAtomic, add, OperationFlags(), requestToken);
 }
 
-void QueuePair::fetchAndAdd(infinity::memory::RegionToken* destination, infinity::memory::Atomic* previousValue, uint64_t add,
+bool QueuePair::fetchAndAdd(infinity::memory::RegionToken* destination, infinity::memory::Atomic* previousValue, uint64_t add,
 		OperationFlags send_flags, infinity::requests::RequestToken *requestToken) {
 
 	if (requestToken != NULL) {
@@ -543,7 +856,6 @@ void QueuePair::fetchAndAdd(infinity::memory::RegionToken* destination, infinity
 
 	struct ibv_sge sgElement;
 	struct ibv_send_wr workRequest;
-	struct ibv_send_wr *badWorkRequest;
 
 	memset(&sgElement, 0, sizeof(ibv_sge));
 	sgElement.addr = previousValue->getAddress();
@@ -563,15 +875,210 @@ void QueuePair::fetchAndAdd(infinity::memory::RegionToken* destination, infinity
 	workRequest.wr.atomic.rkey = destination->getRemoteKey();
 	workRequest.wr.atomic.compare_add = add;
 
-	int returnValue = ibv_post_send(this->ibvQueuePair, &workRequest, &badWorkRequest);
+	int returnValue = postWorkRequests(&workRequest, 1, send_flags.nonBlocking);
+	if (returnValue == EBUSY) {
+		return false;
+	}
 
-	INFINITY_ASSERT(returnValue == 0, "[INFINITY][QUEUES][QUEUEPAIR] Posting fetch-add request failed. %s.\n", strerror(errno));
+	INFINITY_ASSERT(returnValue == 0, "[INFINITY][QUEUES][QUEUEPAIR] Posting fetch-add request failed. %s.\n", strerror(returnValue));
 
 	INFINITY_DEBUG("[INFINITY][QUEUES][QUEUEPAIR] Fetch-add request created (id %lu).\n", workRequest.wr_id);
 
+	return (returnValue == 0);
+
+}
+
+void QueuePair::postBatch(WorkRequestBatch* batch) {
+
+	if (batch->isEmpty()) {
+		return;
+	}
+
+	int returnValue = postWorkRequests(batch->workRequests, batch->getNumberOfWorkRequests(), false);
+
+	INFINITY_ASSERT(returnValue == 0, "[INFINITY][QUEUES][QUEUEPAIR] Posting batch of %u requests failed. %s.\n", batch->getNumberOfWorkRequests(),
+			strerror(returnValue));
+
+	INFINITY_DEBUG("[INFINITY][QUEUES][QUEUEPAIR] Batch of %u requests created.\n", batch->getNumberOfWorkRequests());
+
+	batch->clear();
+
+}
+
+bool QueuePair::tryPostBatch(WorkRequestBatch* batch) {
+
+	if (batch->isEmpty()) {
+		return true;
+	}
+
+	int returnValue = postWorkRequests(batch->workRequests, batch->getNumberOfWorkRequests(), true);
+	if (returnValue == EBUSY) {
+		return false;
+	}
+
+	INFINITY_ASSERT(returnValue == 0, "[INFINITY][QUEUES][QUEUEPAIR] Posting batch of %u requests failed. %s.\n", batch->getNumberOfWorkRequests(),
+			strerror(returnValue));
+
+	INFINITY_DEBUG("[INFINITY][QUEUES][QUEUEPAIR] Batch of %u requests created.\n", batch->getNumberOfWorkRequests());
+
+	batch->clear();
+	return true;
+
+}
+
+void QueuePair::setSignalingInterval(uint32_t signalingInterval) {
+
+	INFINITY_ASSERT(signalingInterval <= this->sendQueueLength / 2,
+			"[INFINITY][QUEUES][QUEUEPAIR] Signaling interval must not be larger than half the send queue length (%u).\n", this->sendQueueLength / 2);
+
+	this->signalingInterval = signalingInterval;
+
+}
+
+uint32_t QueuePair::getSignalingInterval() {
+	return this->signalingInterval;
+}
+
+uint32_t QueuePair::getSendQueueLength() {
+	return this->sendQueueLength;
+}
+
+uint32_t QueuePair::getNumberOfFreeSendQueueSlots() {
+	uint32_t outstandingWorkRequests = this->outstandingWorkRequests.load();
+	return (outstandingWorkRequests < this->sendQueueLength) ? (this->sendQueueLength - outstandingWorkRequests) : 0;
+}
+
+bool QueuePair::isSendQueueFull() {
+	return (getNumberOfFreeSendQueueSlots() == 0);
+}
+
+uint32_t QueuePair::getMaxInlineDataSize() {
+	return this->maxInlineDataSize;
+}
+
+void QueuePair::setInlineThreshold(uint32_t inlineThreshold) {
+
+	INFINITY_ASSERT(inlineThreshold <= this->maxInlineDataSize,
+			"[INFINITY][QUEUES][QUEUEPAIR] Inline threshold must not exceed the inline capacity of %u bytes.\n", this->maxInlineDataSize);
+
+	this->inlineThreshold = inlineThreshold;
+
+}
+
+uint32_t QueuePair::getInlineThreshold() {
+	return this->inlineThreshold;
+}
+
+int QueuePair::postWorkRequests(ibv_send_wr* workRequests, uint32_t numberOfWorkRequests, bool nonBlocking) {
+
+	INFINITY_ASSERT(this->signalingInterval == 0 || numberOfWorkRequests <= this->sendQueueLength / 2,
+			"[INFINITY][QUEUES][QUEUEPAIR] Cannot post more than half the send queue length (%u) at once.\n", this->sendQueueLength / 2);
+
+	// Accounting and posting happen in one critical section, the hardware sees the work requests in the order they were accounted for
+	std::unique_lock<std::mutex> postGuard(this->postLock);
+
+	while (this->signalingInterval > 0 && getNumberOfFreeSendQueueSlots() < numberOfWorkRequests) {
+		if (nonBlocking) {
+			return EBUSY;
+		}
+		postGuard.unlock();
+		if (this->completionQueueGroup->hasProgressEngine() && !this->completionQueueGroup->isProgressEngineThread()) {
+			std::this_thread::yield();
+		} else {
+			this->completionQueueGroup->pollSendCompletionQueue(infinity::core::Configuration::MAX_COMPLETION_BATCH_SIZE);
+		}
+		postGuard.lock();
+	}
+
+	uint32_t unsignaledWorkRequests = this->unsignaledWorkRequests;
+	uint64_t signaledWorkRequestsTail = this->signaledWorkRequestsTail.load(std::memory_order_relaxed);
+
+	prepareWorkRequests(workRequests, numberOfWorkRequests);
+
+	struct ibv_send_wr *badWorkRequest = NULL;
+	int returnValue = ibv_post_send(this->ibvQueuePair, workRequests, &badWorkRequest);
+	if (returnValue == 0) {
+		return 0;
+	}
+
+	// Work requests from the failed one onwards were not posted, only the ones before it remain accounted for
+	if (badWorkRequest == NULL) {
+		badWorkRequest = workRequests;
+	}
+	uint32_t numberOfPostedWorkRequests = 0;
+	for (ibv_send_wr *workRequest = workRequests; workRequest != badWorkRequest; workRequest = workRequest->next) {
+		++numberOfPostedWorkRequests;
+		++unsignaledWorkRequests;
+		if (workRequest->send_flags & IBV_SEND_SIGNALED) {
+			++signaledWorkRequestsTail;
+			unsignaledWorkRequests = 0;
+		}
+	}
+	this->unsignaledWorkRequests = unsignaledWorkRequests;
+	this->signaledWorkRequestsTail.store(signaledWorkRequestsTail, std::memory_order_release);
+	this->outstandingWorkRequests.fetch_sub(numberOfWorkRequests - numberOfPostedWorkRequests);
+
+	// A full send queue is reported as busy as long as nothing was posted
+	if (nonBlocking && returnValue == ENOMEM && numberOfPostedWorkRequests == 0) {
+		return EBUSY;
+	}
+	return returnValue;
+
 }
 
+void QueuePair::prepareWorkRequests(ibv_send_wr* workRequests, uint32_t numberOfWorkRequests) {
+
+	for (ibv_send_wr *workRequest = workRequests; workRequest != NULL; workRequest = workRequest->next) {
 
+		// Tokens poll the group their completion is delivered to
+		if (workRequest->wr_id != 0) {
+			reinterpret_cast<infinity::requests::RequestToken *>(workRequest->wr_id)->completionQueueGroup = this->completionQueueGroup;
+		}
+
+		if (this->inlineThreshold > 0 && (workRequest->opcode == IBV_WR_SEND || workRequest->opcode == IBV_WR_SEND_WITH_IMM
+				|| workRequest->opcode == IBV_WR_RDMA_WRITE || workRequest->opcode == IBV_WR_RDMA_WRITE_WITH_IMM)) {
+			uint64_t sizeInBytes = 0;
+			for (int32_t i = 0; i < workRequest->num_sge; ++i) {
+				sizeInBytes += workRequest->sg_list[i].length;
+			}
+			if (sizeInBytes <= this->inlineThreshold) {
+				workRequest->send_flags |= IBV_SEND_INLINE;
+			}
+		}
+
+		++this->unsignaledWorkRequests;
+		if (this->signalingInterval > 0 && this->unsignaledWorkRequests >= this->signalingInterval) {
+			workRequest->send_flags |= IBV_SEND_SIGNALED;
+		}
+
+		if (workRequest->send_flags & IBV_SEND_SIGNALED) {
+			uint64_t tail = this->signaledWorkRequestsTail.load(std::memory_order_relaxed);
+			this->signaledWorkRequests[tail % this->sendQueueLength] = this->unsignaledWorkRequests;
+			this->signaledWorkRequestsTail.store(tail + 1, std::memory_order_release);
+			this->unsignaledWorkRequests = 0;
+		}
+
+	}
+
+	this->outstandingWorkRequests.fetch_add(numberOfWorkRequests);
+
+}
+
+void QueuePair::retireSignaledWorkRequest(bool success) {
+
+	if (!success) {
+		// The queue pair moved to the error state and all outstanding work requests are flushed
+		this->signaledWorkRequestsHead.store(this->signaledWorkRequestsTail.load(std::memory_order_acquire));
+		this->outstandingWorkRequests.store(0);
+		return;
+	}
+
+	uint64_t head = this->signaledWorkRequestsHead.fetch_add(1);
+	INFINITY_ASSERT(head < this->signaledWorkRequestsTail.load(std::memory_order_acquire),
+			"[INFINITY][QUEUES][QUEUEPAIR] Completion received for untracked work request.\n");
+	this->outstandingWorkRequests.fetch_sub(this->signaledWorkRequests[head % this->sendQueueLength]);
+
+}
 
 bool QueuePair::hasUserData() {
 	return (this->userData != NULL && this->userDataSize != 0);
@@ -585,5 +1092,14 @@ void* QueuePair::getUserData() {
 	return this->userData;
 }
 
+void QueuePair::setUserContext(void* userContext) {
+	this->userContext = userContext;
+	this->completionQueueGroup->registerQueuePair(this);
+}
+
+void* QueuePair::getUserContext() {
+	return this->userContext;
+}
+
 } /* namespace queues */
 } /* namespace infinity */
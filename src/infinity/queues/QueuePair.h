@@ -9,17 +9,28 @@
 #ifndef QUEUES_QUEUEPAIR_H_
 #define QUEUES_QUEUEPAIR_H_
 
+#include <atomic>
+#include <mutex>
 #include <infiniband/verbs.h>
 
+#include <infinity/core/Configuration.h>
 #include <infinity/core/Context.h>
 #include <infinity/memory/Atomic.h>
 #include <infinity/memory/Buffer.h>
 #include <infinity/memory/RegionToken.h>
 #include <infinity/requests/RequestToken.h>
 
+namespace infinity {
+namespace core {
+class CompletionQueueGroup;
+}
+}
+
 namespace infinity {
 namespace queues {
 class QueuePairFactory;
+class SubmissionQueue;
+class WorkRequestBatch;
 }
 }
 
@@ -33,7 +44,12 @@ public:
   bool signaled;
   bool inlined;
 
-  OperationFlags() : fenced(false), signaled(false), inlined(false) { };
+  /**
+   * Return false instead of waiting if the send queue has no room (ignored by work request batches)
+   */
+  bool nonBlocking;
+
+  OperationFlags() : fenced(false), signaled(false), inlined(false), nonBlocking(false) { };
 
   /**
    * Turn the bools into a bit field.
@@ -43,14 +59,17 @@ public:
 
 class QueuePair {
 
+	friend class infinity::core::CompletionQueueGroup;
 	friend class infinity::queues::QueuePairFactory;
+	friend class infinity::queues::SubmissionQueue;
 
 public:
 
 	/**
-	 * Constructor
+	 * Constructor (uses the configuration and default completion queue group of the context if none are given)
 	 */
-	QueuePair(infinity::core::Context *context);
+	QueuePair(infinity::core::Context *context, const infinity::core::Configuration *configuration = NULL,
+			infinity::core::CompletionQueueGroup *completionQueueGroup = NULL);
 
 	/**
 	 * Destructor
@@ -63,7 +82,8 @@ protected:
 	 * Activation methods
 	 */
 
-	void activate(uint16_t remoteDeviceId, uint32_t remoteQueuePairNumber, uint32_t remoteSequenceNumber);
+	void activate(uint16_t remoteDeviceId, uint32_t remoteQueuePairNumber, uint32_t remoteSequenceNumber, uint8_t maxReadAtomic = 1,
+			uint8_t maxDestinationReadAtomic = 1);
 	void setRemoteUserData(void *userData, uint32_t userDataSize);
 
 public:
@@ -76,6 +96,12 @@ public:
 	uint32_t getUserDataSize();
 	void * getUserData();
 
+	/**
+	 * Local pointer handed out with every message received on this queue pair (see receive_element_t)
+	 */
+	void setUserContext(void *userContext);
+	void * getUserContext();
+
 public:
 
 	/**
@@ -86,70 +112,187 @@ public:
 	uint32_t getQueuePairNumber();
 	uint32_t getSequenceNumber();
 
+	/**
+	 * Completion queue group this queue pair completes into
+	 */
+	infinity::core::CompletionQueueGroup * getCompletionQueueGroup();
+
+	/**
+	 * Number of RDMA reads and atomics which can be outstanding at once (negotiated during connection setup)
+	 */
+	uint8_t getMaxOutstandingReadAtomicOperations();
+
 public:
 
 	/**
 	 * Buffer operations
+	 *
+	 * Operations return false if they were not posted and leave the request token uncompleted: with the nonBlocking flag
+	 * if the send queue is full, otherwise only if the device rejected the work request
 	 */
 
-	void send(infinity::memory::Buffer *buffer, infinity::requests::RequestToken *requestToken = NULL);
-	void send(infinity::memory::Buffer *buffer, uint32_t sizeInBytes, infinity::requests::RequestToken *requestToken = NULL);
-	void send(infinity::memory::Buffer *buffer, uint64_t localOffset, uint32_t sizeInBytes, OperationFlags flags,
+	bool send(infinity::memory::Buffer *buffer, infinity::requests::RequestToken *requestToken = NULL);
+	bool send(infinity::memory::Buffer *buffer, uint32_t sizeInBytes, infinity::requests::RequestToken *requestToken = NULL);
+	bool send(infinity::memory::Buffer *buffer, uint64_t localOffset, uint32_t sizeInBytes, OperationFlags flags,
       infinity::requests::RequestToken *requestToken = NULL);
 
-	void write(infinity::memory::Buffer *buffer, infinity::memory::RegionToken *destination, infinity::requests::RequestToken *requestToken = NULL);
-	void write(infinity::memory::Buffer *buffer, infinity::memory::RegionToken *destination, uint32_t sizeInBytes,
+	bool write(infinity::memory::Buffer *buffer, infinity::memory::RegionToken *destination, infinity::requests::RequestToken *requestToken = NULL);
+	bool write(infinity::memory::Buffer *buffer, infinity::memory::RegionToken *destination, uint32_t sizeInBytes,
 			infinity::requests::RequestToken *requestToken = NULL);
-	void write(infinity::memory::Buffer *buffer, uint64_t localOffset, infinity::memory::RegionToken *destination, uint64_t remoteOffset, uint32_t sizeInBytes,
+	bool write(infinity::memory::Buffer *buffer, uint64_t localOffset, infinity::memory::RegionToken *destination, uint64_t remoteOffset, uint32_t sizeInBytes,
       OperationFlags flags, infinity::requests::RequestToken *requestToken = NULL);
 
-	void read(infinity::memory::Buffer *buffer, infinity::memory::RegionToken *source, infinity::requests::RequestToken *requestToken = NULL);
-	void read(infinity::memory::Buffer *buffer, infinity::memory::RegionToken *source, uint32_t sizeInBytes, infinity::requests::RequestToken *requestToken =
+	bool read(infinity::memory::Buffer *buffer, infinity::memory::RegionToken *source, infinity::requests::RequestToken *requestToken = NULL);
+	bool read(infinity::memory::Buffer *buffer, infinity::memory::RegionToken *source, uint32_t sizeInBytes, infinity::requests::RequestToken *requestToken =
 	NULL);
-	void read(infinity::memory::Buffer *buffer, uint64_t localOffset, infinity::memory::RegionToken *source, uint64_t remoteOffset, uint32_t sizeInBytes,
+	bool read(infinity::memory::Buffer *buffer, uint64_t localOffset, infinity::memory::RegionToken *source, uint64_t remoteOffset, uint32_t sizeInBytes,
 			OperationFlags flags, infinity::requests::RequestToken *requestToken = NULL);
 
+public:
+
+	/**
+	 * Inlined operations on unregistered memory (size must not exceed getMaxInlineDataSize())
+	 */
+
+	bool sendInline(const void *data, uint32_t sizeInBytes, infinity::requests::RequestToken *requestToken = NULL);
+	bool writeInline(const void *data, uint32_t sizeInBytes, infinity::memory::RegionToken *destination, uint64_t remoteOffset,
+			infinity::requests::RequestToken *requestToken = NULL);
+
 public:
 
 	/**
 	 * Complex buffer operations
 	 */
 
-	void multiWrite(infinity::memory::Buffer **buffers, uint32_t *sizesInBytes, uint64_t *localOffsets, uint32_t numberOfElements,
+	bool multiWrite(infinity::memory::Buffer **buffers, uint32_t *sizesInBytes, uint64_t *localOffsets, uint32_t numberOfElements,
 			infinity::memory::RegionToken *destination, uint64_t remoteOffset, OperationFlags flags, infinity::requests::RequestToken *requestToken = NULL);
 
-	void sendWithImmediate(infinity::memory::Buffer *buffer, uint64_t localOffset, uint32_t sizeInBytes, uint32_t immediateValue,
+	bool sendWithImmediate(infinity::memory::Buffer *buffer, uint64_t localOffset, uint32_t sizeInBytes, uint32_t immediateValue,
 			OperationFlags flags, infinity::requests::RequestToken *requestToken = NULL);
 
-	void writeWithImmediate(infinity::memory::Buffer *buffer, uint64_t localOffset, infinity::memory::RegionToken *destination, uint64_t remoteOffset,
+	bool writeWithImmediate(infinity::memory::Buffer *buffer, uint64_t localOffset, infinity::memory::RegionToken *destination, uint64_t remoteOffset,
 			uint32_t sizeInBytes, uint32_t immediateValue, OperationFlags flags, infinity::requests::RequestToken *requestToken = NULL);
 
-	void multiWriteWithImmediate(infinity::memory::Buffer **buffers, uint32_t *sizesInBytes, uint64_t *localOffsets, uint32_t numberOfElements,
+	bool multiWriteWithImmediate(infinity::memory::Buffer **buffers, uint32_t *sizesInBytes, uint64_t *localOffsets, uint32_t numberOfElements,
 			infinity::memory::RegionToken *destination, uint64_t remoteOffset, uint32_t immediateValue, OperationFlags flags, infinity::requests::RequestToken *requestToken = NULL);
 
+	/**
+	 * Gather from several local buffers into one message, scatter one remote region into several local buffers
+	 * (sizes and offsets may be NULL to use the complete buffers)
+	 */
+
+	bool multiSend(infinity::memory::Buffer **buffers, uint32_t *sizesInBytes, uint64_t *localOffsets, uint32_t numberOfElements, OperationFlags flags,
+			infinity::requests::RequestToken *requestToken = NULL);
+
+	bool multiSendWithImmediate(infinity::memory::Buffer **buffers, uint32_t *sizesInBytes, uint64_t *localOffsets, uint32_t numberOfElements,
+			uint32_t immediateValue, OperationFlags flags, infinity::requests::RequestToken *requestToken = NULL);
+
+	bool multiRead(infinity::memory::Buffer **buffers, uint32_t *sizesInBytes, uint64_t *localOffsets, uint32_t numberOfElements,
+			infinity::memory::RegionToken *source, uint64_t remoteOffset, OperationFlags flags, infinity::requests::RequestToken *requestToken = NULL);
+
 public:
 
 	/**
 	 * Atomic value operations
 	 */
 
-	void compareAndSwap(infinity::memory::RegionToken *destination, uint64_t compare, uint64_t swap, infinity::requests::RequestToken *requestToken = NULL);
-	void compareAndSwap(infinity::memory::RegionToken *destination, infinity::memory::Atomic *previousValue, uint64_t compare, uint64_t swap,
+	bool compareAndSwap(infinity::memory::RegionToken *destination, uint64_t compare, uint64_t swap, infinity::requests::RequestToken *requestToken = NULL);
+	bool compareAndSwap(infinity::memory::RegionToken *destination, infinity::memory::Atomic *previousValue, uint64_t compare, uint64_t swap,
 			OperationFlags flags, infinity::requests::RequestToken *requestToken = NULL);
-	void fetchAndAdd(infinity::memory::RegionToken *destination, uint64_t add, infinity::requests::RequestToken *requestToken = NULL);
-	void fetchAndAdd(infinity::memory::RegionToken *destination, infinity::memory::Atomic *previousValue, uint64_t add,
+	bool fetchAndAdd(infinity::memory::RegionToken *destination, uint64_t add, infinity::requests::RequestToken *requestToken = NULL);
+	bool fetchAndAdd(infinity::memory::RegionToken *destination, infinity::memory::Atomic *previousValue, uint64_t add,
 			OperationFlags flags, infinity::requests::RequestToken *requestToken = NULL);
 
+public:
+
+	/**
+	 * Batched operations
+	 * (tryPostBatch returns false instead of waiting if the send queue has no room for the complete batch)
+	 */
+
+	void postBatch(WorkRequestBatch *batch);
+	bool tryPostBatch(WorkRequestBatch *batch);
+
+public:
+
+	/**
+	 * Selective signaling and send queue tracking
+	 */
+
+	void setSignalingInterval(uint32_t signalingInterval);
+	uint32_t getSignalingInterval();
+
+	uint32_t getSendQueueLength();
+	uint32_t getNumberOfFreeSendQueueSlots();
+	bool isSendQueueFull();
+
+public:
+
+	/**
+	 * Automatic inlining of sends and writes up to the inline threshold (0 disables automatic inlining)
+	 */
+
+	uint32_t getMaxInlineDataSize();
+	void setInlineThreshold(uint32_t inlineThreshold);
+	uint32_t getInlineThreshold();
+
+protected:
+
+	/**
+	 * Fill the given scatter-gather list, returns the total size in bytes
+	 */
+	uint64_t fillScatterGatherElements(ibv_sge *sgElements, infinity::memory::Buffer **buffers, uint32_t *sizesInBytes, uint64_t *localOffsets, uint32_t numberOfElements);
+
+	/**
+	 * Post a chain of work requests, blocks until the send queue has room in automatic signaling mode
+	 * Returns EBUSY instead of blocking if nonBlocking is set, the accounting is undone for work requests which were not posted
+	 */
+	int postWorkRequests(ibv_send_wr *workRequests, uint32_t numberOfWorkRequests, bool nonBlocking);
+
+	/**
+	 * Apply signaling and inlining policies and account for work requests before they are posted (caller holds the post lock)
+	 */
+	void prepareWorkRequests(ibv_send_wr *workRequests, uint32_t numberOfWorkRequests);
+
+	/**
+	 * Retire a signaled work request and all unsignaled work requests posted before it
+	 */
+	void retireSignaledWorkRequest(bool success);
+
 protected:
 
 	infinity::core::Context * const context;
+	infinity::core::CompletionQueueGroup * const completionQueueGroup;
+	infinity::core::Configuration configuration;
 
 	ibv_qp* ibvQueuePair;
 	uint32_t sequenceNumber;
+	uint8_t maxOutstandingReadAtomicOperations;
+
+	uint32_t maxInlineDataSize;
+	uint32_t inlineThreshold;
+
+	uint32_t maxNumberOfReadSgeElements;
+
+	uint32_t sendQueueLength;
+	uint32_t signalingInterval;
+
+	/**
+	 * Posting threads are serialized, completions retire work requests without the lock
+	 */
+	std::mutex postLock;
+	uint32_t unsignaledWorkRequests;
+	std::atomic<uint32_t> outstandingWorkRequests;
+
+	uint32_t *signaledWorkRequests;
+	std::atomic<uint64_t> signaledWorkRequestsHead;
+	std::atomic<uint64_t> signaledWorkRequestsTail;
 
 	void *userData;
 	uint32_t userDataSize;
 
+	void *userContext;
+
 };
 
 } /* namespace queues */
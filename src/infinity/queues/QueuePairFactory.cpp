@@ -13,10 +13,13 @@
 #include <arpa/inet.h>
 #include  <sys/socket.h>
 
+#include <infinity/core/CompletionQueueGroup.h>
 #include <infinity/core/Configuration.h>
 #include <infinity/utils/Debug.h>
 #include <infinity/utils/Address.h>
 
+#define MIN(a,b) (((a)<(b)) ? (a) : (b))
+
 namespace infinity {
 namespace queues {
 
@@ -25,14 +28,19 @@ typedef struct {
 	uint16_t localDeviceId;
 	uint32_t queuePairNumber;
 	uint32_t sequenceNumber;
+	uint8_t initiatorReadAtomicLimit;
+	uint8_t responderReadAtomicLimit;
 	uint32_t userDataSize;
 	char userData[infinity::core::Configuration::MAX_CONNECTION_USER_DATA_SIZE];
 
 } serializedQueuePair;
 
-QueuePairFactory::QueuePairFactory(infinity::core::Context *context) {
+QueuePairFactory::QueuePairFactory(infinity::core::Context *context, const infinity::core::Configuration *configuration,
+		infinity::core::CompletionQueueGroup *completionQueueGroup) :
+		configuration((configuration != NULL) ? *configuration : *(context->getConfiguration())) {
 
 	this->context = context;
+	this->completionQueueGroup = completionQueueGroup;
 	this->serverSocket = -1;
 
 }
@@ -86,11 +94,13 @@ QueuePair * QueuePairFactory::acceptIncomingConnection(void *userData, uint32_t
 	INFINITY_ASSERT(returnValue == sizeof(serializedQueuePair), "[INFINITY][QUEUES][FACTORY] Incorrect number of bytes received. Expected %lu. Received %d.\n",
 			sizeof(serializedQueuePair), returnValue);
 
-	QueuePair *queuePair = new QueuePair(this->context);
+	QueuePair *queuePair = new QueuePair(this->context, &(this->configuration), this->completionQueueGroup);
 
 	sendBuffer->localDeviceId = queuePair->getLocalDeviceId();
 	sendBuffer->queuePairNumber = queuePair->getQueuePairNumber();
 	sendBuffer->sequenceNumber = queuePair->getSequenceNumber();
+	sendBuffer->initiatorReadAtomicLimit = getLocalInitiatorReadAtomicLimit();
+	sendBuffer->responderReadAtomicLimit = getLocalResponderReadAtomicLimit();
 	sendBuffer->userDataSize = userDataSizeInBytes;
 	memcpy(sendBuffer->userData, userData, userDataSizeInBytes);
 
@@ -102,10 +112,13 @@ QueuePair * QueuePairFactory::acceptIncomingConnection(void *userData, uint32_t
 			queuePair->getSequenceNumber(), userDataSizeInBytes, receiveBuffer->localDeviceId, receiveBuffer->queuePairNumber, receiveBuffer->sequenceNumber,
 			receiveBuffer->userDataSize);
 
-	queuePair->activate(receiveBuffer->localDeviceId, receiveBuffer->queuePairNumber, receiveBuffer->sequenceNumber);
+	// Issue at most as many reads and atomics as the remote side accepts
+	uint8_t maxReadAtomic = MIN(getLocalInitiatorReadAtomicLimit(), receiveBuffer->responderReadAtomicLimit);
+	queuePair->activate(receiveBuffer->localDeviceId, receiveBuffer->queuePairNumber, receiveBuffer->sequenceNumber, maxReadAtomic,
+			getLocalResponderReadAtomicLimit());
 	queuePair->setRemoteUserData(receiveBuffer->userData, receiveBuffer->userDataSize);
 
-	this->context->registerQueuePair(queuePair);
+	queuePair->getCompletionQueueGroup()->registerQueuePair(queuePair);
 
 	close(connectionSocket);
 	free(receiveBuffer);
@@ -135,11 +148,13 @@ QueuePair * QueuePairFactory::connectToRemoteHost(const char* hostAddress, uint1
 	int returnValue = connect(connectionSocket, (sockaddr *) &(remoteAddress), sizeof(sockaddr_in));
 	INFINITY_ASSERT(returnValue == 0, "[INFINITY][QUEUES][FACTORY] Could not connect to server.\n");
 
-	QueuePair *queuePair = new QueuePair(this->context);
+	QueuePair *queuePair = new QueuePair(this->context, &(this->configuration), this->completionQueueGroup);
 
 	sendBuffer->localDeviceId = queuePair->getLocalDeviceId();
 	sendBuffer->queuePairNumber = queuePair->getQueuePairNumber();
 	sendBuffer->sequenceNumber = queuePair->getSequenceNumber();
+	sendBuffer->initiatorReadAtomicLimit = getLocalInitiatorReadAtomicLimit();
+	sendBuffer->responderReadAtomicLimit = getLocalResponderReadAtomicLimit();
 	sendBuffer->userDataSize = userDataSizeInBytes;
 	memcpy(sendBuffer->userData, userData, userDataSizeInBytes);
 
@@ -155,10 +170,13 @@ QueuePair * QueuePairFactory::connectToRemoteHost(const char* hostAddress, uint1
 			queuePair->getSequenceNumber(), userDataSizeInBytes, receiveBuffer->localDeviceId, receiveBuffer->queuePairNumber, receiveBuffer->sequenceNumber,
 			receiveBuffer->userDataSize);
 
-	queuePair->activate(receiveBuffer->localDeviceId, receiveBuffer->queuePairNumber, receiveBuffer->sequenceNumber);
+	// Issue at most as many reads and atomics as the remote side accepts
+	uint8_t maxReadAtomic = MIN(getLocalInitiatorReadAtomicLimit(), receiveBuffer->responderReadAtomicLimit);
+	queuePair->activate(receiveBuffer->localDeviceId, receiveBuffer->queuePairNumber, receiveBuffer->sequenceNumber, maxReadAtomic,
+			getLocalResponderReadAtomicLimit());
 	queuePair->setRemoteUserData(receiveBuffer->userData, receiveBuffer->userDataSize);
 
-	this->context->registerQueuePair(queuePair);
+	queuePair->getCompletionQueueGroup()->registerQueuePair(queuePair);
 
 	close(connectionSocket);
 	free(receiveBuffer);
@@ -170,15 +188,41 @@ QueuePair * QueuePairFactory::connectToRemoteHost(const char* hostAddress, uint1
 
 QueuePair* QueuePairFactory::createLoopback(void *userData, uint32_t userDataSizeInBytes) {
 
-	QueuePair *queuePair = new QueuePair(this->context);
-	queuePair->activate(queuePair->getLocalDeviceId(), queuePair->getQueuePairNumber(), queuePair->getSequenceNumber());
+	QueuePair *queuePair = new QueuePair(this->context, &(this->configuration), this->completionQueueGroup);
+	uint8_t maxReadAtomic = MIN(getLocalInitiatorReadAtomicLimit(), getLocalResponderReadAtomicLimit());
+	queuePair->activate(queuePair->getLocalDeviceId(), queuePair->getQueuePairNumber(), queuePair->getSequenceNumber(), maxReadAtomic,
+			getLocalResponderReadAtomicLimit());
 	queuePair->setRemoteUserData(userData, userDataSizeInBytes);
 
-	this->context->registerQueuePair(queuePair);
+	queuePair->getCompletionQueueGroup()->registerQueuePair(queuePair);
 
 	return queuePair;
 
 }
 
+void QueuePairFactory::setMaxOutstandingReadAtomicOperations(uint8_t maxOutstandingReadAtomicOperations) {
+	this->configuration.maxOutstandingReadAtomicOperations = maxOutstandingReadAtomicOperations;
+}
+
+void QueuePairFactory::setCompletionQueueGroup(infinity::core::CompletionQueueGroup* completionQueueGroup) {
+	this->completionQueueGroup = completionQueueGroup;
+}
+
+uint8_t QueuePairFactory::getLocalInitiatorReadAtomicLimit() {
+	uint32_t limit = MIN(this->context->getDeviceAttributes()->max_qp_init_rd_atom, UINT8_MAX);
+	if (this->configuration.maxOutstandingReadAtomicOperations > 0) {
+		limit = MIN(limit, this->configuration.maxOutstandingReadAtomicOperations);
+	}
+	return static_cast<uint8_t>(limit);
+}
+
+uint8_t QueuePairFactory::getLocalResponderReadAtomicLimit() {
+	uint32_t limit = MIN(this->context->getDeviceAttributes()->max_qp_rd_atom, UINT8_MAX);
+	if (this->configuration.maxOutstandingReadAtomicOperations > 0) {
+		limit = MIN(limit, this->configuration.maxOutstandingReadAtomicOperations);
+	}
+	return static_cast<uint8_t>(limit);
+}
+
 } /* namespace queues */
 } /* namespace infinity */
@@ -12,6 +12,7 @@
 #include <stdlib.h>
 #include <stdint.h>
 
+#include <infinity/core/Configuration.h>
 #include <infinity/core/Context.h>
 #include <infinity/queues/QueuePair.h>
 
@@ -21,7 +22,11 @@ namespace queues {
 class QueuePairFactory {
 public:
 
-	QueuePairFactory(infinity::core::Context *context);
+	/**
+	 * Queue pairs are created with the given configuration and completion queue group or those of the context
+	 */
+	QueuePairFactory(infinity::core::Context *context, const infinity::core::Configuration *configuration = NULL,
+			infinity::core::CompletionQueueGroup *completionQueueGroup = NULL);
 	~QueuePairFactory();
 
 	/**
@@ -44,9 +49,29 @@ public:
 	 */
 	QueuePair * createLoopback(void *userData = NULL, uint32_t userDataSizeInBytes = 0);
 
+	/**
+	 * Limit the number of outstanding RDMA reads and atomics per queue pair (0 uses the device limits)
+	 */
+	void setMaxOutstandingReadAtomicOperations(uint8_t maxOutstandingReadAtomicOperations);
+
+	/**
+	 * Bind queue pairs created from now on to the given completion queue group (NULL for the default group of the context)
+	 */
+	void setCompletionQueueGroup(infinity::core::CompletionQueueGroup *completionQueueGroup);
+
+protected:
+
+	/**
+	 * Number of reads and atomics this side can issue (initiator) and accept (responder)
+	 */
+	uint8_t getLocalInitiatorReadAtomicLimit();
+	uint8_t getLocalResponderReadAtomicLimit();
+
 protected:
 
 	infinity::core::Context * context;
+	infinity::core::Configuration configuration;
+	infinity::core::CompletionQueueGroup *completionQueueGroup;
 
 	int32_t serverSocket;
 
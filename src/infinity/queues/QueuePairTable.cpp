@@ -0,0 +1,184 @@
+/**
+ * Queues - Queue Pair Table
+ *
+ * (c) 2018 Claude Barthels, ETH Zurich
+ * Contact: claudeb@inf.ethz.ch
+ *
+ */
+
+#include "QueuePairTable.h"
+
+#include <stdlib.h>
+
+#include <infinity/utils/Debug.h>
+
+namespace infinity {
+namespace queues {
+
+QueuePairTable::QueuePairTable(uint32_t capacity) {
+
+	INFINITY_ASSERT(capacity > 0 && (capacity & (capacity - 1)) == 0, "[INFINITY][QUEUES][TABLE] Capacity must be a power of two.\n");
+
+	this->numberOfEntries = 0;
+	this->numberOfRemovedSlots = 0;
+	this->numberOfActiveLookups.store(0);
+	this->currentTable.store(createTable(capacity));
+
+}
+
+QueuePairTable::~QueuePairTable() {
+
+	this->retiredTables.push_back(this->currentTable.load());
+	for (uint64_t i = 0; i < this->retiredTables.size(); ++i) {
+		free(this->retiredTables[i]->slots);
+		delete this->retiredTables[i];
+	}
+
+}
+
+void QueuePairTable::insert(uint32_t queuePairNumber, QueuePair* queuePair, void* userContext) {
+
+	std::lock_guard<std::mutex> guard(this->writeLock);
+	reclaimRetiredTables();
+
+	// Keep at least half of the slots empty so that probe sequences stay short
+	table_t *table = this->currentTable.load(std::memory_order_relaxed);
+	if (2 * (this->numberOfEntries + this->numberOfRemovedSlots + 1) > table->mask + 1) {
+		uint32_t capacity = table->mask + 1;
+		while (2 * (this->numberOfEntries + 1) > capacity / 2) {
+			capacity *= 2;
+		}
+		rebuild(capacity);
+		table = this->currentTable.load(std::memory_order_relaxed);
+	}
+
+	slot_t *freeSlot = NULL;
+	for (uint32_t i = 0; i <= table->mask; ++i) {
+		slot_t *slot = &(table->slots[(queuePairNumber + i) & table->mask]);
+		uint32_t key = slot->key.load(std::memory_order_relaxed);
+		if (key == queuePairNumber) {
+			slot->queuePair.store(queuePair, std::memory_order_relaxed);
+			slot->userContext.store(userContext, std::memory_order_release);
+			return;
+		}
+		if (key == REMOVED_KEY && freeSlot == NULL) {
+			freeSlot = slot;
+		}
+		if (key == EMPTY_KEY) {
+			if (freeSlot == NULL) {
+				freeSlot = slot;
+			}
+			break;
+		}
+	}
+
+	if (freeSlot->key.load(std::memory_order_relaxed) == REMOVED_KEY) {
+		--this->numberOfRemovedSlots;
+	}
+
+	// Publish the values before the key becomes visible to readers
+	freeSlot->queuePair.store(queuePair, std::memory_order_relaxed);
+	freeSlot->userContext.store(userContext, std::memory_order_relaxed);
+	freeSlot->key.store(queuePairNumber, std::memory_order_release);
+	++this->numberOfEntries;
+
+}
+
+void QueuePairTable::remove(uint32_t queuePairNumber, QueuePair* queuePair) {
+
+	std::lock_guard<std::mutex> guard(this->writeLock);
+	reclaimRetiredTables();
+
+	table_t *table = this->currentTable.load(std::memory_order_relaxed);
+	for (uint32_t i = 0; i <= table->mask; ++i) {
+		slot_t *slot = &(table->slots[(queuePairNumber + i) & table->mask]);
+		uint32_t key = slot->key.load(std::memory_order_relaxed);
+		if (key == queuePairNumber) {
+			if (slot->queuePair.load(std::memory_order_relaxed) == queuePair) {
+				slot->key.store(REMOVED_KEY, std::memory_order_release);
+				slot->queuePair.store(NULL, std::memory_order_relaxed);
+				slot->userContext.store(NULL, std::memory_order_relaxed);
+				--this->numberOfEntries;
+				++this->numberOfRemovedSlots;
+			}
+			return;
+		}
+		if (key == EMPTY_KEY) {
+			return;
+		}
+	}
+
+}
+
+uint32_t QueuePairTable::getNumberOfEntries() {
+	std::lock_guard<std::mutex> guard(this->writeLock);
+	return this->numberOfEntries;
+}
+
+QueuePairTable::table_t* QueuePairTable::createTable(uint32_t capacity) {
+
+	table_t *table = new table_t;
+	table->mask = capacity - 1;
+
+	void *memory;
+	int returnValue = posix_memalign(&memory, infinity::core::Configuration::CACHE_LINE_SIZE, capacity * sizeof(slot_t));
+	INFINITY_ASSERT(returnValue == 0, "[INFINITY][QUEUES][TABLE] Cannot allocate queue pair table.\n");
+
+	table->slots = reinterpret_cast<slot_t *>(memory);
+	for (uint32_t i = 0; i < capacity; ++i) {
+		table->slots[i].key.store(EMPTY_KEY, std::memory_order_relaxed);
+		table->slots[i].queuePair.store(NULL, std::memory_order_relaxed);
+		table->slots[i].userContext.store(NULL, std::memory_order_relaxed);
+	}
+
+	return table;
+
+}
+
+void QueuePairTable::rebuild(uint32_t capacity) {
+
+	table_t *oldTable = this->currentTable.load(std::memory_order_relaxed);
+	table_t *newTable = createTable(capacity);
+
+	for (uint32_t i = 0; i <= oldTable->mask; ++i) {
+		uint32_t key = oldTable->slots[i].key.load(std::memory_order_relaxed);
+		if (key == EMPTY_KEY || key == REMOVED_KEY) {
+			continue;
+		}
+		for (uint32_t j = 0; j <= newTable->mask; ++j) {
+			slot_t *slot = &(newTable->slots[(key + j) & newTable->mask]);
+			if (slot->key.load(std::memory_order_relaxed) == EMPTY_KEY) {
+				slot->queuePair.store(oldTable->slots[i].queuePair.load(std::memory_order_relaxed), std::memory_order_relaxed);
+				slot->userContext.store(oldTable->slots[i].userContext.load(std::memory_order_relaxed), std::memory_order_relaxed);
+				slot->key.store(key, std::memory_order_relaxed);
+				break;
+			}
+		}
+	}
+
+	this->currentTable.store(newTable, std::memory_order_seq_cst);
+	this->retiredTables.push_back(oldTable);
+	this->numberOfRemovedSlots = 0;
+	reclaimRetiredTables();
+
+	INFINITY_DEBUG("[INFINITY][QUEUES][TABLE] Rebuilt queue pair table with %u slots.\n", capacity);
+
+}
+
+void QueuePairTable::reclaimRetiredTables() {
+
+	// Lookups starting after this check load the current table, which is never retired while the lock is held
+	if (this->retiredTables.empty() || this->numberOfActiveLookups.load(std::memory_order_seq_cst) != 0) {
+		return;
+	}
+
+	for (uint64_t i = 0; i < this->retiredTables.size(); ++i) {
+		free(this->retiredTables[i]->slots);
+		delete this->retiredTables[i];
+	}
+	this->retiredTables.clear();
+
+}
+
+} /* namespace queues */
+} /* namespace infinity */
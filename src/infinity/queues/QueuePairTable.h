@@ -0,0 +1,129 @@
+/**
+ * Queues - Queue Pair Table
+ *
+ * (c) 2018 Claude Barthels, ETH Zurich
+ * Contact: claudeb@inf.ethz.ch
+ *
+ */
+
+#ifndef QUEUES_QUEUEPAIRTABLE_H_
+#define QUEUES_QUEUEPAIRTABLE_H_
+
+#include <atomic>
+#include <mutex>
+#include <stdint.h>
+#include <vector>
+
+#include <infinity/core/Configuration.h>
+
+namespace infinity {
+namespace queues {
+class QueuePair;
+}
+}
+
+namespace infinity {
+namespace queues {
+
+/**
+ * Maps queue pair numbers to queue pairs and their user context, indexed directly by the low bits of the number
+ * Lookups are lock-free and may run concurrently to insertions and removals, which are serialized internally
+ * Tables replaced by a rebuild are freed by the next insertion or removal which finds no lookup in progress
+ */
+class QueuePairTable {
+
+public:
+
+	/**
+	 * Constructor (capacity must be a power of two)
+	 */
+	QueuePairTable(uint32_t capacity = infinity::core::Configuration::QUEUE_PAIR_TABLE_SIZE);
+	~QueuePairTable();
+
+public:
+
+	/**
+	 * Add the queue pair or update the user context of an existing entry
+	 */
+	void insert(uint32_t queuePairNumber, QueuePair *queuePair, void *userContext);
+
+	/**
+	 * Remove the entry if it still belongs to the given queue pair
+	 */
+	void remove(uint32_t queuePairNumber, QueuePair *queuePair);
+
+	/**
+	 * Returns NULL if the number is unknown, the user context is only written if the queue pair was found
+	 */
+	inline QueuePair * lookup(uint32_t queuePairNumber, void **userContext = NULL) {
+
+		// Announce the lookup before loading the table, writers only free replaced tables while no lookup is in progress
+		this->numberOfActiveLookups.fetch_add(1, std::memory_order_seq_cst);
+		table_t *table = this->currentTable.load(std::memory_order_seq_cst);
+
+		QueuePair *queuePair = NULL;
+		for (uint32_t i = 0; i <= table->mask; ++i) {
+			slot_t *slot = &(table->slots[(queuePairNumber + i) & table->mask]);
+			uint32_t key = slot->key.load(std::memory_order_acquire);
+			if (key == queuePairNumber) {
+				if (userContext != NULL) {
+					*userContext = slot->userContext.load(std::memory_order_relaxed);
+				}
+				queuePair = slot->queuePair.load(std::memory_order_relaxed);
+				break;
+			}
+			if (key == EMPTY_KEY) {
+				break;
+			}
+		}
+
+		this->numberOfActiveLookups.fetch_sub(1, std::memory_order_release);
+		return queuePair;
+
+	}
+
+	uint32_t getNumberOfEntries();
+
+protected:
+
+	// Queue pair numbers have 24 bits, keys outside this range mark free slots
+	static const uint32_t EMPTY_KEY = 0xFFFFFFFF;
+	static const uint32_t REMOVED_KEY = 0xFFFFFFFE;
+
+	typedef struct {
+		std::atomic<uint32_t> key;
+		std::atomic<QueuePair *> queuePair;
+		std::atomic<void *> userContext;
+	} slot_t;
+
+	typedef struct {
+		uint32_t mask;
+		slot_t *slots;
+	} table_t;
+
+	table_t * createTable(uint32_t capacity);
+	void rebuild(uint32_t capacity);
+	void reclaimRetiredTables();
+
+protected:
+
+	std::atomic<table_t *> currentTable;
+
+	/**
+	 * Replaced tables are kept until no lookup is in progress, a lookup may still be reading them
+	 */
+	std::vector<table_t *> retiredTables;
+
+	char padding[infinity::core::Configuration::CACHE_LINE_SIZE];
+	std::atomic<uint32_t> numberOfActiveLookups;
+
+	std::mutex writeLock;
+	uint32_t numberOfEntries;
+	uint32_t numberOfRemovedSlots;
+
+};
+
+} /* namespace queues */
+} /* namespace infinity */
+
+#endif /* QUEUES_QUEUEPAIRTABLE_H_ */
@@ -0,0 +1,222 @@
+/**
+ * Queues - Ring Buffer Channel
+ *
+ * (c) 2018 Claude Barthels, ETH Zurich
+ * Contact: claudeb@inf.ethz.ch
+ *
+ */
+
+#include "RingBufferChannel.h"
+
+#include <atomic>
+#include <new>
+#include <stdlib.h>
+#include <string.h>
+
+#include <infinity/utils/Debug.h>
+
+#define MAX(a,b) ((a) > (b) ? (a) : (b))
+
+namespace infinity {
+namespace queues {
+
+RingBufferChannel::RingBufferChannel(infinity::core::Context* context, uint32_t ringSizeInBytes) :
+		context(context), ringSizeInBytes(ringSizeInBytes) {
+
+	INFINITY_ASSERT(ringSizeInBytes >= infinity::core::Configuration::PAGE_SIZE && (ringSizeInBytes & (ringSizeInBytes - 1)) == 0,
+			"[INFINITY][QUEUES][CHANNEL] Ring size must be a power of two of at least %u bytes.\n", infinity::core::Configuration::PAGE_SIZE);
+
+	this->queuePair = NULL;
+
+	// Records are only recognized in zeroed memory
+	this->receiveRing = new infinity::memory::Buffer(context, ringSizeInBytes);
+	memset(this->receiveRing->getData(), 0, ringSizeInBytes);
+	this->controlBuffer = new infinity::memory::Buffer(context, 2 * infinity::core::Configuration::CACHE_LINE_SIZE);
+	memset(this->controlBuffer->getData(), 0, 2 * infinity::core::Configuration::CACHE_LINE_SIZE);
+	this->sendRing = new infinity::memory::Buffer(context, ringSizeInBytes);
+
+	infinity::memory::RegionToken *ringToken = this->receiveRing->createRegionToken();
+	infinity::memory::RegionToken *controlToken = this->controlBuffer->createRegionToken(0, sizeof(uint64_t));
+	this->connectionData = reinterpret_cast<infinity::memory::RegionToken *>(malloc(2 * sizeof(infinity::memory::RegionToken)));
+	::new (&(this->connectionData[0])) infinity::memory::RegionToken(*ringToken);
+	::new (&(this->connectionData[1])) infinity::memory::RegionToken(*controlToken);
+	delete ringToken;
+	delete controlToken;
+
+	this->remoteRingToken = NULL;
+	this->remoteControlToken = NULL;
+
+	this->tail = 0;
+	this->head = 0;
+	this->writtenBackHead = 0;
+	this->pendingRecordSize = 0;
+
+}
+
+RingBufferChannel::~RingBufferChannel() {
+
+	delete this->remoteRingToken;
+	delete this->remoteControlToken;
+
+	free(this->connectionData);
+	delete this->sendRing;
+	delete this->controlBuffer;
+	delete this->receiveRing;
+
+}
+
+void* RingBufferChannel::getConnectionData() {
+	return this->connectionData;
+}
+
+uint32_t RingBufferChannel::getConnectionDataSize() {
+	return 2 * sizeof(infinity::memory::RegionToken);
+}
+
+void RingBufferChannel::connect(QueuePair* queuePair) {
+
+	INFINITY_ASSERT(this->queuePair == NULL, "[INFINITY][QUEUES][CHANNEL] Channel is already connected.\n");
+	INFINITY_ASSERT(queuePair->hasUserData() && queuePair->getUserDataSize() == getConnectionDataSize(),
+			"[INFINITY][QUEUES][CHANNEL] Queue pair was not established with the connection data of a channel.\n");
+
+	infinity::memory::RegionToken *remoteConnectionData = reinterpret_cast<infinity::memory::RegionToken *>(queuePair->getUserData());
+	INFINITY_ASSERT(remoteConnectionData[0].getSizeInBytes() == this->ringSizeInBytes,
+			"[INFINITY][QUEUES][CHANNEL] Remote ring has %lu bytes, local ring has %u bytes.\n", remoteConnectionData[0].getSizeInBytes(),
+			this->ringSizeInBytes);
+
+	this->remoteRingToken = new infinity::memory::RegionToken(remoteConnectionData[0]);
+	this->remoteControlToken = new infinity::memory::RegionToken(remoteConnectionData[1]);
+	this->queuePair = queuePair;
+
+	// Writes are unsignaled, without a signaling interval they are never retired and the send queue fills up
+	if (queuePair->getSignalingInterval() == 0) {
+		queuePair->setSignalingInterval(MAX(queuePair->getSendQueueLength() / 4, 1));
+	}
+
+}
+
+bool RingBufferChannel::send(const void* data, uint32_t sizeInBytes, infinity::requests::RequestToken* requestToken) {
+
+	INFINITY_ASSERT(this->queuePair != NULL, "[INFINITY][QUEUES][CHANNEL] Channel is not connected.\n");
+	INFINITY_ASSERT(sizeInBytes <= getMaxMessageSize(), "[INFINITY][QUEUES][CHANNEL] Message of %u bytes exceeds maximum of %u bytes.\n", sizeInBytes,
+			getMaxMessageSize());
+
+	uint32_t recordSize = getRecordSize(sizeInBytes);
+	uint32_t offset = this->tail & (this->ringSizeInBytes - 1);
+	uint32_t bytesUntilEnd = this->ringSizeInBytes - offset;
+	uint32_t requiredBytes = (recordSize <= bytesUntilEnd) ? recordSize : bytesUntilEnd + recordSize;
+
+	if (getNumberOfFreeBytes() < requiredBytes) {
+		return false;
+	}
+
+	char *ring = reinterpret_cast<char *>(this->sendRing->getData());
+
+	// Records do not wrap around, the receiver skips the rest of the ring when it finds a wrap record
+	if (recordSize > bytesUntilEnd) {
+		header_t *wrapHeader = reinterpret_cast<header_t *>(ring + offset);
+		wrapHeader->sizeInBytes = 0;
+		wrapHeader->type = RECORD_TYPE_WRAP;
+		this->queuePair->write(this->sendRing, offset, this->remoteRingToken, offset, sizeof(header_t), OperationFlags(), NULL);
+		this->tail += bytesUntilEnd;
+		offset = 0;
+	}
+
+	header_t *header = reinterpret_cast<header_t *>(ring + offset);
+	header->sizeInBytes = sizeInBytes;
+	header->type = RECORD_TYPE_MESSAGE;
+	memcpy(ring + offset + sizeof(header_t), data, sizeInBytes);
+	*reinterpret_cast<uint64_t *>(ring + offset + recordSize - sizeof(uint64_t)) = TRAILER_VALID;
+
+	if (!this->queuePair->write(this->sendRing, offset, this->remoteRingToken, offset, recordSize, OperationFlags(), requestToken)) {
+		return false;
+	}
+	this->tail += recordSize;
+
+	return true;
+
+}
+
+bool RingBufferChannel::receive(void** data, uint32_t* sizeInBytes) {
+
+	INFINITY_ASSERT(this->pendingRecordSize == 0, "[INFINITY][QUEUES][CHANNEL] Previous message was not released.\n");
+
+	char *ring = reinterpret_cast<char *>(this->receiveRing->getData());
+
+	while (true) {
+
+		uint32_t offset = this->head & (this->ringSizeInBytes - 1);
+		volatile header_t *header = reinterpret_cast<volatile header_t *>(ring + offset);
+
+		uint32_t type = header->type;
+		if (type == 0) {
+			return false;
+		}
+
+		if (type == RECORD_TYPE_WRAP) {
+			header->sizeInBytes = 0;
+			header->type = 0;
+			this->head += this->ringSizeInBytes - offset;
+			continue;
+		}
+
+		// The header may already be visible while the rest of the record is still being written
+		uint32_t recordSize = getRecordSize(header->sizeInBytes);
+		volatile uint64_t *trailer = reinterpret_cast<volatile uint64_t *>(ring + offset + recordSize - sizeof(uint64_t));
+		if (*trailer != TRAILER_VALID) {
+			return false;
+		}
+		std::atomic_thread_fence(std::memory_order_acquire);
+
+		*data = ring + offset + sizeof(header_t);
+		*sizeInBytes = header->sizeInBytes;
+		this->pendingRecordSize = recordSize;
+		return true;
+
+	}
+
+}
+
+void RingBufferChannel::release() {
+
+	INFINITY_ASSERT(this->pendingRecordSize > 0, "[INFINITY][QUEUES][CHANNEL] No message to release.\n");
+
+	char *ring = reinterpret_cast<char *>(this->receiveRing->getData());
+	memset(ring + (this->head & (this->ringSizeInBytes - 1)), 0, this->pendingRecordSize);
+	this->head += this->pendingRecordSize;
+	this->pendingRecordSize = 0;
+
+	if (this->head - this->writtenBackHead >= this->ringSizeInBytes / 4) {
+		writeBackHead();
+	}
+
+}
+
+uint32_t RingBufferChannel::getRingSizeInBytes() {
+	return this->ringSizeInBytes;
+}
+
+uint32_t RingBufferChannel::getMaxMessageSize() {
+	// A sender blocked on a record of this size always waits for more than a quarter of the ring, which triggers a write-back
+	return this->ringSizeInBytes / 4 - sizeof(header_t) - sizeof(uint64_t);
+}
+
+uint32_t RingBufferChannel::getNumberOfFreeBytes() {
+	uint64_t remoteHead = *reinterpret_cast<volatile uint64_t *>(this->controlBuffer->getData());
+	return this->ringSizeInBytes - (this->tail - remoteHead);
+}
+
+void RingBufferChannel::writeBackHead() {
+
+	uint64_t *headToWrite = reinterpret_cast<uint64_t *>(reinterpret_cast<char *>(this->controlBuffer->getData())
+			+ infinity::core::Configuration::CACHE_LINE_SIZE);
+	*headToWrite = this->head;
+
+	this->queuePair->write(this->controlBuffer, infinity::core::Configuration::CACHE_LINE_SIZE, this->remoteControlToken, 0, sizeof(uint64_t),
+			OperationFlags(), NULL);
+	this->writtenBackHead = this->head;
+
+}
+
+} /* namespace queues */
+} /* namespace infinity */
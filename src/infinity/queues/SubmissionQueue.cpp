@@ -0,0 +1,290 @@
+/**
+ * Queues - Submission Queue
+ *
+ * (c) 2018 Claude Barthels, ETH Zurich
+ * Contact: claudeb@inf.ethz.ch
+ *
+ */
+
+#include "SubmissionQueue.h"
+
+#include <infinity/utils/Debug.h>
+
+#define MIN(a,b) (((a)<(b)) ? (a) : (b))
+#define MAX(a,b) ((a) > (b) ? (a) : (b))
+
+namespace infinity {
+namespace queues {
+
+SubmissionQueue::SubmissionQueue(QueuePair* queuePair, uint32_t length) :
+		queuePair(queuePair), length(length) {
+
+	INFINITY_ASSERT(length > 0 && (length & (length - 1)) == 0, "[INFINITY][QUEUES][SUBMISSION] Length must be a power of two.\n");
+
+	this->slots = new slot_t[length];
+	for (uint32_t i = 0; i < length; ++i) {
+		this->slots[i].sequence.store(i, std::memory_order_relaxed);
+	}
+
+	// Chains must not exceed half the send queue when signaling automatically
+	uint32_t batchSize = MIN(infinity::core::Configuration::SUBMISSION_BATCH_SIZE, MAX(queuePair->getSendQueueLength() / 2, 1));
+	this->batch = new WorkRequestBatch(queuePair->context, batchSize);
+
+	this->enqueuePosition.store(0);
+	this->dequeuePosition = 0;
+	this->draining.clear();
+
+}
+
+SubmissionQueue::~SubmissionQueue() {
+
+	delete this->batch;
+	delete[] this->slots;
+
+}
+
+bool SubmissionQueue::send(infinity::memory::Buffer* buffer, infinity::requests::RequestToken* requestToken) {
+	return send(buffer, 0, buffer->getSizeInBytes(), OperationFlags(), requestToken);
+}
+
+bool SubmissionQueue::send(infinity::memory::Buffer* buffer, uint64_t localOffset, uint32_t sizeInBytes, OperationFlags flags,
+		infinity::requests::RequestToken* requestToken) {
+
+	operation_t operation;
+	operation.type = SEND;
+	operation.buffer = buffer;
+	operation.localOffset = localOffset;
+	operation.sizeInBytes = sizeInBytes;
+	operation.flags = flags;
+	operation.requestToken = requestToken;
+	return enqueue(&operation);
+
+}
+
+bool SubmissionQueue::write(infinity::memory::Buffer* buffer, infinity::memory::RegionToken* destination, infinity::requests::RequestToken* requestToken) {
+	return write(buffer, 0, destination, 0, buffer->getSizeInBytes(), OperationFlags(), requestToken);
+}
+
+bool SubmissionQueue::write(infinity::memory::Buffer* buffer, uint64_t localOffset, infinity::memory::RegionToken* destination, uint64_t remoteOffset,
+		uint32_t sizeInBytes, OperationFlags flags, infinity::requests::RequestToken* requestToken) {
+
+	operation_t operation;
+	operation.type = WRITE;
+	operation.buffer = buffer;
+	operation.localOffset = localOffset;
+	operation.remoteRegion = destination;
+	operation.remoteOffset = remoteOffset;
+	operation.sizeInBytes = sizeInBytes;
+	operation.flags = flags;
+	operation.requestToken = requestToken;
+	return enqueue(&operation);
+
+}
+
+bool SubmissionQueue::read(infinity::memory::Buffer* buffer, infinity::memory::RegionToken* source, infinity::requests::RequestToken* requestToken) {
+	return read(buffer, 0, source, 0, buffer->getSizeInBytes(), OperationFlags(), requestToken);
+}
+
+bool SubmissionQueue::read(infinity::memory::Buffer* buffer, uint64_t localOffset, infinity::memory::RegionToken* source, uint64_t remoteOffset,
+		uint32_t sizeInBytes, OperationFlags flags, infinity::requests::RequestToken* requestToken) {
+
+	operation_t operation;
+	operation.type = READ;
+	operation.buffer = buffer;
+	operation.localOffset = localOffset;
+	operation.remoteRegion = source;
+	operation.remoteOffset = remoteOffset;
+	operation.sizeInBytes = sizeInBytes;
+	operation.flags = flags;
+	operation.requestToken = requestToken;
+	return enqueue(&operation);
+
+}
+
+bool SubmissionQueue::sendWithImmediate(infinity::memory::Buffer* buffer, uint64_t localOffset, uint32_t sizeInBytes, uint32_t immediateValue,
+		OperationFlags flags, infinity::requests::RequestToken* requestToken) {
+
+	operation_t operation;
+	operation.type = SEND_WITH_IMMEDIATE;
+	operation.buffer = buffer;
+	operation.localOffset = localOffset;
+	operation.sizeInBytes = sizeInBytes;
+	operation.immediateValue = immediateValue;
+	operation.flags = flags;
+	operation.requestToken = requestToken;
+	return enqueue(&operation);
+
+}
+
+bool SubmissionQueue::writeWithImmediate(infinity::memory::Buffer* buffer, uint64_t localOffset, infinity::memory::RegionToken* destination,
+		uint64_t remoteOffset, uint32_t sizeInBytes, uint32_t immediateValue, OperationFlags flags, infinity::requests::RequestToken* requestToken) {
+
+	operation_t operation;
+	operation.type = WRITE_WITH_IMMEDIATE;
+	operation.buffer = buffer;
+	operation.localOffset = localOffset;
+	operation.remoteRegion = destination;
+	operation.remoteOffset = remoteOffset;
+	operation.sizeInBytes = sizeInBytes;
+	operation.immediateValue = immediateValue;
+	operation.flags = flags;
+	operation.requestToken = requestToken;
+	return enqueue(&operation);
+
+}
+
+bool SubmissionQueue::compareAndSwap(infinity::memory::RegionToken* destination, infinity::memory::Atomic* previousValue, uint64_t compare, uint64_t swap,
+		OperationFlags flags, infinity::requests::RequestToken* requestToken) {
+
+	operation_t operation;
+	operation.type = COMPARE_AND_SWAP;
+	operation.previousValue = previousValue;
+	operation.remoteRegion = destination;
+	operation.compareOrAdd = compare;
+	operation.swap = swap;
+	operation.flags = flags;
+	operation.requestToken = requestToken;
+	return enqueue(&operation);
+
+}
+
+bool SubmissionQueue::fetchAndAdd(infinity::memory::RegionToken* destination, infinity::memory::Atomic* previousValue, uint64_t add,
+		OperationFlags flags, infinity::requests::RequestToken* requestToken) {
+
+	operation_t operation;
+	operation.type = FETCH_AND_ADD;
+	operation.previousValue = previousValue;
+	operation.remoteRegion = destination;
+	operation.compareOrAdd = add;
+	operation.flags = flags;
+	operation.requestToken = requestToken;
+	return enqueue(&operation);
+
+}
+
+uint32_t SubmissionQueue::drain() {
+
+	if (this->draining.test_and_set(std::memory_order_acquire)) {
+		return 0;
+	}
+
+	uint32_t numberOfWorkRequests = 0;
+	operation_t operation;
+
+	while (true) {
+		while (!this->batch->isFull() && dequeue(&operation)) {
+			appendToBatch(&operation);
+		}
+		if (this->batch->isEmpty()) {
+			break;
+		}
+		// Never wait for free send queue slots here, the draining thread may be the one polling for them
+		uint32_t numberOfWorkRequestsInBatch = this->batch->getNumberOfWorkRequests();
+		if (!this->queuePair->tryPostBatch(this->batch)) {
+			break;
+		}
+		numberOfWorkRequests += numberOfWorkRequestsInBatch;
+	}
+
+	this->draining.clear(std::memory_order_release);
+
+	return numberOfWorkRequests;
+
+}
+
+bool SubmissionQueue::isEmpty() {
+
+	// Empty once the slot of the last reserved position was consumed, the next free slot only tells whether the queue is full
+	uint64_t position = this->enqueuePosition.load(std::memory_order_acquire);
+	if (position == 0) {
+		return true;
+	}
+	uint64_t sequence = this->slots[(position - 1) & (this->length - 1)].sequence.load(std::memory_order_acquire);
+	return sequence == position - 1 + this->length;
+
+}
+
+bool SubmissionQueue::hasUnpostedWorkRequests() {
+	return !this->batch->isEmpty();
+}
+
+QueuePair* SubmissionQueue::getQueuePair() {
+	return this->queuePair;
+}
+
+bool SubmissionQueue::enqueue(operation_t* operation) {
+
+	// Reset now, the submitting thread may check the token before the operation is posted
+	if (operation->requestToken != NULL) {
+		operation->requestToken->reset();
+	}
+
+	uint64_t position = this->enqueuePosition.load(std::memory_order_relaxed);
+	while (true) {
+		slot_t *slot = &(this->slots[position & (this->length - 1)]);
+		uint64_t sequence = slot->sequence.load(std::memory_order_acquire);
+		int64_t difference = static_cast<int64_t>(sequence - position);
+		if (difference == 0) {
+			if (this->enqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+				slot->operation = *operation;
+				slot->sequence.store(position + 1, std::memory_order_release);
+				return true;
+			}
+		} else if (difference < 0) {
+			return false;
+		} else {
+			position = this->enqueuePosition.load(std::memory_order_relaxed);
+		}
+	}
+
+}
+
+bool SubmissionQueue::dequeue(operation_t* operation) {
+
+	slot_t *slot = &(this->slots[this->dequeuePosition & (this->length - 1)]);
+	if (slot->sequence.load(std::memory_order_acquire) != this->dequeuePosition + 1) {
+		return false;
+	}
+
+	*operation = slot->operation;
+	slot->sequence.store(this->dequeuePosition + this->length, std::memory_order_release);
+	++this->dequeuePosition;
+	return true;
+
+}
+
+void SubmissionQueue::appendToBatch(operation_t* operation) {
+
+	switch (operation->type) {
+		case SEND:
+			this->batch->send(operation->buffer, operation->localOffset, operation->sizeInBytes, operation->flags, operation->requestToken);
+			break;
+		case SEND_WITH_IMMEDIATE:
+			this->batch->sendWithImmediate(operation->buffer, operation->localOffset, operation->sizeInBytes, operation->immediateValue, operation->flags,
+					operation->requestToken);
+			break;
+		case WRITE:
+			this->batch->write(operation->buffer, operation->localOffset, operation->remoteRegion, operation->remoteOffset, operation->sizeInBytes,
+					operation->flags, operation->requestToken);
+			break;
+		case WRITE_WITH_IMMEDIATE:
+			this->batch->writeWithImmediate(operation->buffer, operation->localOffset, operation->remoteRegion, operation->remoteOffset,
+					operation->sizeInBytes, operation->immediateValue, operation->flags, operation->requestToken);
+			break;
+		case READ:
+			this->batch->read(operation->buffer, operation->localOffset, operation->remoteRegion, operation->remoteOffset, operation->sizeInBytes,
+					operation->flags, operation->requestToken);
+			break;
+		case COMPARE_AND_SWAP:
+			this->batch->compareAndSwap(operation->remoteRegion, operation->previousValue, operation->compareOrAdd, operation->swap, operation->flags,
+					operation->requestToken);
+			break;
+		case FETCH_AND_ADD:
+			this->batch->fetchAndAdd(operation->remoteRegion, operation->previousValue, operation->compareOrAdd, operation->flags, operation->requestToken);
+			break;
+	}
+
+}
+
+} /* namespace queues */
+} /* namespace infinity */
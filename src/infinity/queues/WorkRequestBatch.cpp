@@ -0,0 +1,233 @@
+/**
+ * Queues - Work Request Batch
+ *
+ * (c) 2018 Claude Barthels, ETH Zurich
+ * Contact: claudeb@inf.ethz.ch
+ *
+ */
+
+#include "WorkRequestBatch.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <arpa/inet.h>
+
+#include <infinity/utils/Debug.h>
+
+namespace infinity {
+namespace queues {
+
+WorkRequestBatch::WorkRequestBatch(infinity::core::Context* context, uint32_t maxNumberOfWorkRequests) :
+		context(context), maxNumberOfWorkRequests(maxNumberOfWorkRequests) {
+
+	INFINITY_ASSERT(maxNumberOfWorkRequests > 0, "[INFINITY][QUEUES][BATCH] Batch must hold at least one work request.\n");
+
+	this->workRequests = (ibv_send_wr *) calloc(maxNumberOfWorkRequests, sizeof(ibv_send_wr));
+	this->sgElements = (ibv_sge *) calloc(maxNumberOfWorkRequests, sizeof(ibv_sge));
+	INFINITY_ASSERT(this->workRequests != NULL && this->sgElements != NULL, "[INFINITY][QUEUES][BATCH] Cannot allocate work requests.\n");
+
+	this->numberOfWorkRequests = 0;
+
+}
+
+WorkRequestBatch::~WorkRequestBatch() {
+
+	free(this->workRequests);
+	free(this->sgElements);
+
+}
+
+uint32_t WorkRequestBatch::getNumberOfWorkRequests() {
+	return this->numberOfWorkRequests;
+}
+
+uint32_t WorkRequestBatch::getMaxNumberOfWorkRequests() {
+	return this->maxNumberOfWorkRequests;
+}
+
+bool WorkRequestBatch::isEmpty() {
+	return (this->numberOfWorkRequests == 0);
+}
+
+bool WorkRequestBatch::isFull() {
+	return (this->numberOfWorkRequests == this->maxNumberOfWorkRequests);
+}
+
+void WorkRequestBatch::clear() {
+	this->numberOfWorkRequests = 0;
+}
+
+ibv_send_wr* WorkRequestBatch::appendWorkRequest(infinity::memory::Region* region, uint64_t localOffset, uint32_t sizeInBytes, OperationFlags flags,
+		infinity::requests::RequestToken* requestToken) {
+
+	INFINITY_ASSERT(this->numberOfWorkRequests < this->maxNumberOfWorkRequests, "[INFINITY][QUEUES][BATCH] Batch is full.\n");
+
+	if (requestToken != NULL) {
+		requestToken->reset();
+		requestToken->setRegion(region);
+	}
+
+	uint32_t index = this->numberOfWorkRequests++;
+
+	ibv_sge *sgElement = &(this->sgElements[index]);
+	sgElement->addr = region->getAddress() + localOffset;
+	sgElement->length = sizeInBytes;
+	sgElement->lkey = region->getLocalKey();
+
+	ibv_send_wr *workRequest = &(this->workRequests[index]);
+	memset(workRequest, 0, sizeof(ibv_send_wr));
+	workRequest->wr_id = reinterpret_cast<uint64_t>(requestToken);
+	workRequest->sg_list = sgElement;
+	workRequest->num_sge = 1;
+	workRequest->send_flags = flags.ibvFlags();
+	if (requestToken != NULL) {
+		workRequest->send_flags |= IBV_SEND_SIGNALED;
+	}
+
+	if (index > 0) {
+		this->workRequests[index - 1].next = workRequest;
+	}
+
+	return workRequest;
+
+}
+
+void WorkRequestBatch::send(infinity::memory::Buffer* buffer, infinity::requests::RequestToken* requestToken) {
+	send(buffer, 0, buffer->getSizeInBytes(), OperationFlags(), requestToken);
+}
+
+void WorkRequestBatch::send(infinity::memory::Buffer* buffer, uint32_t sizeInBytes, infinity::requests::RequestToken* requestToken) {
+	send(buffer, 0, sizeInBytes, OperationFlags(), requestToken);
+}
+
+void WorkRequestBatch::send(infinity::memory::Buffer* buffer, uint64_t localOffset, uint32_t sizeInBytes, OperationFlags flags,
+		infinity::requests::RequestToken* requestToken) {
+
+	INFINITY_ASSERT(sizeInBytes <= buffer->getRemainingSizeInBytes(localOffset),
+			"[INFINITY][QUEUES][BATCH] Segmentation fault while creating scatter-getter element.\n");
+
+	ibv_send_wr *workRequest = appendWorkRequest(buffer, localOffset, sizeInBytes, flags, requestToken);
+	workRequest->opcode = IBV_WR_SEND;
+
+}
+
+void WorkRequestBatch::sendWithImmediate(infinity::memory::Buffer* buffer, uint64_t localOffset, uint32_t sizeInBytes, uint32_t immediateValue,
+		OperationFlags flags, infinity::requests::RequestToken* requestToken) {
+
+	INFINITY_ASSERT(sizeInBytes <= buffer->getRemainingSizeInBytes(localOffset),
+			"[INFINITY][QUEUES][BATCH] Segmentation fault while creating scatter-getter element.\n");
+
+	ibv_send_wr *workRequest = appendWorkRequest(buffer, localOffset, sizeInBytes, flags, requestToken);
+	workRequest->opcode = IBV_WR_SEND_WITH_IMM;
+	workRequest->imm_data = htonl(immediateValue);
+
+	if (requestToken != NULL) {
+		requestToken->setImmediateValue(immediateValue);
+	}
+
+}
+
+void WorkRequestBatch::write(infinity::memory::Buffer* buffer, infinity::memory::RegionToken* destination, infinity::requests::RequestToken* requestToken) {
+	INFINITY_ASSERT(buffer->getSizeInBytes() <= ((uint64_t) UINT32_MAX), "[INFINITY][QUEUES][BATCH] Request must be smaller or equal to UINT_32_MAX bytes. This memory region is larger. Please explicitly indicate the size of the data to transfer.\n");
+	write(buffer, 0, destination, 0, buffer->getSizeInBytes(), OperationFlags(), requestToken);
+}
+
+void WorkRequestBatch::write(infinity::memory::Buffer* buffer, infinity::memory::RegionToken* destination, uint32_t sizeInBytes,
+		infinity::requests::RequestToken* requestToken) {
+	write(buffer, 0, destination, 0, sizeInBytes, OperationFlags(), requestToken);
+}
+
+void WorkRequestBatch::write(infinity::memory::Buffer* buffer, uint64_t localOffset, infinity::memory::RegionToken* destination, uint64_t remoteOffset,
+		uint32_t sizeInBytes, OperationFlags flags, infinity::requests::RequestToken* requestToken) {
+
+	INFINITY_ASSERT(sizeInBytes <= buffer->getRemainingSizeInBytes(localOffset),
+			"[INFINITY][QUEUES][BATCH] Segmentation fault while creating scatter-getter element.\n");
+	INFINITY_ASSERT(sizeInBytes <= destination->getRemainingSizeInBytes(remoteOffset),
+			"[INFINITY][QUEUES][BATCH] Segmentation fault while writing to remote memory.\n");
+
+	ibv_send_wr *workRequest = appendWorkRequest(buffer, localOffset, sizeInBytes, flags, requestToken);
+	workRequest->opcode = IBV_WR_RDMA_WRITE;
+	workRequest->wr.rdma.remote_addr = destination->getAddress() + remoteOffset;
+	workRequest->wr.rdma.rkey = destination->getRemoteKey();
+
+}
+
+void WorkRequestBatch::writeWithImmediate(infinity::memory::Buffer* buffer, uint64_t localOffset, infinity::memory::RegionToken* destination,
+		uint64_t remoteOffset, uint32_t sizeInBytes, uint32_t immediateValue, OperationFlags flags, infinity::requests::RequestToken* requestToken) {
+
+	INFINITY_ASSERT(sizeInBytes <= buffer->getRemainingSizeInBytes(localOffset),
+			"[INFINITY][QUEUES][BATCH] Segmentation fault while creating scatter-getter element.\n");
+	INFINITY_ASSERT(sizeInBytes <= destination->getRemainingSizeInBytes(remoteOffset),
+			"[INFINITY][QUEUES][BATCH] Segmentation fault while writing to remote memory.\n");
+
+	ibv_send_wr *workRequest = appendWorkRequest(buffer, localOffset, sizeInBytes, flags, requestToken);
+	workRequest->opcode = IBV_WR_RDMA_WRITE_WITH_IMM;
+	workRequest->imm_data = htonl(immediateValue);
+	workRequest->wr.rdma.remote_addr = destination->getAddress() + remoteOffset;
+	workRequest->wr.rdma.rkey = destination->getRemoteKey();
+
+	if (requestToken != NULL) {
+		requestToken->setImmediateValue(immediateValue);
+	}
+
+}
+
+void WorkRequestBatch::read(infinity::memory::Buffer* buffer, infinity::memory::RegionToken* source, infinity::requests::RequestToken* requestToken) {
+	INFINITY_ASSERT(buffer->getSizeInBytes() <= ((uint64_t) UINT32_MAX), "[INFINITY][QUEUES][BATCH] Request must be smaller or equal to UINT_32_MAX bytes. This memory region is larger. Please explicitly indicate the size of the data to transfer.\n");
+	read(buffer, 0, source, 0, buffer->getSizeInBytes(), OperationFlags(), requestToken);
+}
+
+void WorkRequestBatch::read(infinity::memory::Buffer* buffer, infinity::memory::RegionToken* source, uint32_t sizeInBytes,
+		infinity::requests::RequestToken* requestToken) {
+	read(buffer, 0, source, 0, sizeInBytes, OperationFlags(), requestToken);
+}
+
+void WorkRequestBatch::read(infinity::memory::Buffer* buffer, uint64_t localOffset, infinity::memory::RegionToken* source, uint64_t remoteOffset,
+		uint32_t sizeInBytes, OperationFlags flags, infinity::requests::RequestToken* requestToken) {
+
+	INFINITY_ASSERT(sizeInBytes <= buffer->getRemainingSizeInBytes(localOffset),
+			"[INFINITY][QUEUES][BATCH] Segmentation fault while creating scatter-getter element.\n");
+	INFINITY_ASSERT(sizeInBytes <= source->getRemainingSizeInBytes(remoteOffset),
+			"[INFINITY][QUEUES][BATCH] Segmentation fault while reading from remote memory.\n");
+
+	ibv_send_wr *workRequest = appendWorkRequest(buffer, localOffset, sizeInBytes, flags, requestToken);
+	workRequest->opcode = IBV_WR_RDMA_READ;
+	workRequest->wr.rdma.remote_addr = source->getAddress() + remoteOffset;
+	workRequest->wr.rdma.rkey = source->getRemoteKey();
+
+}
+
+void WorkRequestBatch::compareAndSwap(infinity::memory::RegionToken* destination, uint64_t compare, uint64_t swap,
+		infinity::requests::RequestToken* requestToken) {
+	compareAndSwap(destination, context->defaultAtomic, compare, swap, OperationFlags(), requestToken);
+}
+
+void WorkRequestBatch::compareAndSwap(infinity::memory::RegionToken* destination, infinity::memory::Atomic* previousValue, uint64_t compare, uint64_t swap,
+		OperationFlags flags, infinity::requests::RequestToken* requestToken) {
+
+	ibv_send_wr *workRequest = appendWorkRequest(previousValue, 0, previousValue->getSizeInBytes(), flags, requestToken);
+	workRequest->opcode = IBV_WR_ATOMIC_CMP_AND_SWP;
+	workRequest->wr.atomic.remote_addr = destination->getAddress();
+	workRequest->wr.atomic.rkey = destination->getRemoteKey();
+	workRequest->wr.atomic.compare_add = compare;
+	workRequest->wr.atomic.swap = swap;
+
+}
+
+void WorkRequestBatch::fetchAndAdd(infinity::memory::RegionToken* destination, uint64_t add, infinity::requests::RequestToken* requestToken) {
+	fetchAndAdd(destination, context->defaultAtomic, add, OperationFlags(), requestToken);
+}
+
+void WorkRequestBatch::fetchAndAdd(infinity::memory::RegionToken* destination, infinity::memory::Atomic* previousValue, uint64_t add,
+		OperationFlags flags, infinity::requests::RequestToken* requestToken) {
+
+	ibv_send_wr *workRequest = appendWorkRequest(previousValue, 0, previousValue->getSizeInBytes(), flags, requestToken);
+	workRequest->opcode = IBV_WR_ATOMIC_FETCH_AND_ADD;
+	workRequest->wr.atomic.remote_addr = destination->getAddress();
+	workRequest->wr.atomic.rkey = destination->getRemoteKey();
+	workRequest->wr.atomic.compare_add = add;
+
+}
+
+} /* namespace queues */
+} /* namespace infinity */
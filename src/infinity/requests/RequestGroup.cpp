@@ -0,0 +1,167 @@
+/**
+ * Requests - Request Group
+ *
+ * (c) 2018 Claude Barthels, ETH Zurich
+ * Contact: claudeb@inf.ethz.ch
+ *
+ */
+
+#include "RequestGroup.h"
+
+#include <infinity/utils/Debug.h>
+
+namespace infinity {
+namespace requests {
+
+RequestGroup::RequestGroup(infinity::core::Context* context, uint32_t maxNumberOfRequests) :
+		RequestGroup(context->getDefaultCompletionQueueGroup(), maxNumberOfRequests) {
+}
+
+RequestGroup::RequestGroup(infinity::core::CompletionQueueGroup* completionQueueGroup, uint32_t maxNumberOfRequests) :
+		completionQueueGroup(completionQueueGroup), maxNumberOfRequests(maxNumberOfRequests) {
+
+	this->requestTokens = new RequestToken *[maxNumberOfRequests];
+	this->completionOrder = new std::atomic<RequestToken *>[maxNumberOfRequests];
+	for (uint32_t i = 0; i < maxNumberOfRequests; ++i) {
+		this->completionOrder[i].store(NULL);
+	}
+
+	this->numberOfRequests = 0;
+	this->numberOfReturnedRequests = 0;
+	this->numberOfRequiredCompletions = 0;
+	this->numberOfReservedPositions.store(0);
+	this->numberOfCompletedRequests.store(0);
+	this->numberOfFailedRequests.store(0);
+
+}
+
+RequestGroup::~RequestGroup() {
+
+	detachRequestTokens();
+
+	delete[] this->completionOrder;
+	delete[] this->requestTokens;
+
+}
+
+void RequestGroup::add(RequestToken* requestToken) {
+
+	INFINITY_ASSERT(this->numberOfRequests < this->maxNumberOfRequests, "[INFINITY][REQUESTS][GROUP] Group can track at most %u requests.\n",
+			this->maxNumberOfRequests);
+
+	requestToken->setCompletionCallback(&RequestGroup::onCompletion, this);
+	this->requestTokens[this->numberOfRequests++] = requestToken;
+
+}
+
+void RequestGroup::waitAll() {
+	waitFor(this->numberOfRequests);
+}
+
+RequestToken* RequestGroup::waitAny() {
+
+	if (this->numberOfReturnedRequests == this->numberOfRequests) {
+		return NULL;
+	}
+
+	if (this->completionOrder[this->numberOfReturnedRequests].load(std::memory_order_acquire) == NULL) {
+		this->completionQueueGroup->waitForSendCompletions(&RequestGroup::hasUnreturnedCompletion, this);
+	}
+
+	return this->completionOrder[this->numberOfReturnedRequests++].load(std::memory_order_acquire);
+
+}
+
+void RequestGroup::waitFor(uint32_t numberOfRequests) {
+
+	INFINITY_ASSERT(numberOfRequests <= this->numberOfRequests, "[INFINITY][REQUESTS][GROUP] Waiting for %u of %u requests.\n", numberOfRequests,
+			this->numberOfRequests);
+
+	if (this->numberOfCompletedRequests.load(std::memory_order_acquire) >= numberOfRequests) {
+		return;
+	}
+
+	this->numberOfRequiredCompletions = numberOfRequests;
+	this->completionQueueGroup->waitForSendCompletions(&RequestGroup::hasEnoughCompletions, this);
+
+}
+
+void RequestGroup::reset() {
+
+	INFINITY_ASSERT(this->numberOfCompletedRequests.load() == this->numberOfRequests,
+			"[INFINITY][REQUESTS][GROUP] Group reset while %u requests are outstanding.\n",
+			this->numberOfRequests - this->numberOfCompletedRequests.load());
+
+	detachRequestTokens();
+
+	for (uint32_t i = 0; i < this->numberOfRequests; ++i) {
+		this->completionOrder[i].store(NULL, std::memory_order_relaxed);
+	}
+
+	this->numberOfRequests = 0;
+	this->numberOfReturnedRequests = 0;
+	this->numberOfReservedPositions.store(0);
+	this->numberOfCompletedRequests.store(0);
+	this->numberOfFailedRequests.store(0);
+
+}
+
+uint32_t RequestGroup::getNumberOfRequests() {
+	return this->numberOfRequests;
+}
+
+uint32_t RequestGroup::getNumberOfCompletedRequests() {
+	return this->numberOfCompletedRequests.load();
+}
+
+uint32_t RequestGroup::getNumberOfFailedRequests() {
+	return this->numberOfFailedRequests.load();
+}
+
+bool RequestGroup::wasSuccessful() {
+	return this->numberOfCompletedRequests.load() == this->numberOfRequests && this->numberOfFailedRequests.load() == 0;
+}
+
+void RequestGroup::onCompletion(RequestToken* requestToken, void* callbackContext) {
+
+	RequestGroup *requestGroup = reinterpret_cast<RequestGroup *>(callbackContext);
+
+	// Each added token is counted once, reusing it afterwards does not complete into the group again
+	requestToken->clearCompletionCallback();
+
+	if (!requestToken->wasSuccessful()) {
+		requestGroup->numberOfFailedRequests.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	// The completed count is raised last, waiters may reset or delete the group as soon as it is reached
+	uint32_t position = requestGroup->numberOfReservedPositions.fetch_add(1, std::memory_order_relaxed);
+	requestGroup->completionOrder[position].store(requestToken, std::memory_order_release);
+	requestGroup->numberOfCompletedRequests.fetch_add(1, std::memory_order_release);
+
+}
+
+void RequestGroup::detachRequestTokens() {
+
+	// Tokens which never completed still carry the callback of the group, completed ones may belong to someone else by now
+	std::atomic_thread_fence(std::memory_order_acquire);
+	for (uint32_t i = 0; i < this->numberOfRequests; ++i) {
+		RequestToken *requestToken = this->requestTokens[i];
+		if (requestToken->completionCallback == &RequestGroup::onCompletion && requestToken->callbackContext == this) {
+			requestToken->clearCompletionCallback();
+		}
+	}
+
+}
+
+bool RequestGroup::hasEnoughCompletions(void* requestGroup) {
+	RequestGroup *group = reinterpret_cast<RequestGroup *>(requestGroup);
+	return group->numberOfCompletedRequests.load(std::memory_order_acquire) >= group->numberOfRequiredCompletions;
+}
+
+bool RequestGroup::hasUnreturnedCompletion(void* requestGroup) {
+	RequestGroup *group = reinterpret_cast<RequestGroup *>(requestGroup);
+	return group->completionOrder[group->numberOfReturnedRequests].load(std::memory_order_acquire) != NULL;
+}
+
+} /* namespace requests */
+} /* namespace infinity */
@@ -0,0 +1,121 @@
+/**
+ * Requests - Request Group
+ *
+ * (c) 2018 Claude Barthels, ETH Zurich
+ * Contact: claudeb@inf.ethz.ch
+ *
+ */
+
+#ifndef REQUESTS_REQUESTGROUP_H_
+#define REQUESTS_REQUESTGROUP_H_
+
+#include <atomic>
+#include <stdint.h>
+
+#include <infinity/core/CompletionQueueGroup.h>
+#include <infinity/core/Configuration.h>
+#include <infinity/core/Context.h>
+#include <infinity/requests/RequestToken.h>
+
+namespace infinity {
+namespace requests {
+
+/**
+ * Counts the completions of a set of request tokens, waiting for all, any or k of them is done in a single polling loop
+ * Tokens must be used on queue pairs of the completion queue group the request group was created for
+ */
+class RequestGroup {
+
+public:
+
+	/**
+	 * Tracks up to maxNumberOfRequests tokens completing into the given group (or the default group of the context)
+	 */
+	RequestGroup(infinity::core::Context *context, uint32_t maxNumberOfRequests);
+	RequestGroup(infinity::core::CompletionQueueGroup *completionQueueGroup, uint32_t maxNumberOfRequests);
+	~RequestGroup();
+
+public:
+
+	/**
+	 * Track the next operation issued with this token, must be called before the operation is posted
+	 * The completion callback of the token is replaced by the group and cleared once the operation completed
+	 * (or when the group is reset or deleted), the token can be reused afterwards
+	 */
+	void add(RequestToken *requestToken);
+
+	/**
+	 * Wait until all added tokens completed
+	 */
+	void waitAll();
+
+	/**
+	 * Wait until another token completed and return it, tokens are returned in completion order
+	 * Returns NULL once every added token was returned
+	 */
+	RequestToken * waitAny();
+
+	/**
+	 * Wait until at least numberOfRequests of the added tokens completed
+	 */
+	void waitFor(uint32_t numberOfRequests);
+
+	/**
+	 * Clear the group for the next round of requests, all added tokens must have completed
+	 */
+	void reset();
+
+public:
+
+	uint32_t getNumberOfRequests();
+	uint32_t getNumberOfCompletedRequests();
+	uint32_t getNumberOfFailedRequests();
+
+	/**
+	 * True if all added tokens completed successfully
+	 */
+	bool wasSuccessful();
+
+protected:
+
+	static void onCompletion(RequestToken *requestToken, void *callbackContext);
+
+	/**
+	 * Remove the callback of the group from added tokens
+	 */
+	void detachRequestTokens();
+
+	/**
+	 * Completion conditions used while waiting
+	 */
+	static bool hasEnoughCompletions(void *requestGroup);
+	static bool hasUnreturnedCompletion(void *requestGroup);
+
+protected:
+
+	infinity::core::CompletionQueueGroup * const completionQueueGroup;
+	const uint32_t maxNumberOfRequests;
+
+	/**
+	 * Owned by the waiting thread
+	 */
+	uint32_t numberOfRequests;
+	uint32_t numberOfReturnedRequests;
+	uint32_t numberOfRequiredCompletions;
+	RequestToken **requestTokens;
+	std::atomic<RequestToken *> *completionOrder;
+
+	/**
+	 * Written by the thread processing the completions
+	 */
+	char padding[infinity::core::Configuration::CACHE_LINE_SIZE];
+	std::atomic<uint32_t> numberOfReservedPositions;
+	std::atomic<uint32_t> numberOfCompletedRequests;
+	std::atomic<uint32_t> numberOfFailedRequests;
+
+};
+
+} /* namespace requests */
+} /* namespace infinity */
+
+#endif /* REQUESTS_REQUESTGROUP_H_ */
@@ -8,48 +8,108 @@
 
 #include "RequestToken.h"
 
+#include <new>
+#include <stdlib.h>
+
+#include <infinity/core/CompletionQueueGroup.h>
+#include <infinity/core/Configuration.h>
+#include <infinity/requests/RequestTokenPool.h>
+
 namespace infinity {
 namespace requests {
 
 RequestToken::RequestToken(infinity::core::Context *context) :
 		context(context) {
-	this->success.store(false);
-	this->completed.store(false);
+	this->completionQueueGroup = context->getDefaultCompletionQueueGroup();
+	this->state.store(0);
+	this->completionCallback = NULL;
+	this->callbackContext = NULL;
 	this->region = NULL;
 	this->userData = NULL;
 	this->userDataValid = false;
 	this->userDataSize = 0;
 	this->immediateValue = 0;
 	this->immediateValueValid = false;
+	this->pool = NULL;
+	this->nextFreeToken = NULL;
+	this->releaseOnCompletion = false;
+}
+
+void* RequestToken::operator new(size_t size) {
+	void *pointer;
+	if (posix_memalign(&pointer, infinity::core::Configuration::CACHE_LINE_SIZE, size) != 0) {
+		throw std::bad_alloc();
+	}
+	return pointer;
+}
+
+void* RequestToken::operator new[](size_t size) {
+	return RequestToken::operator new(size);
+}
+
+void RequestToken::operator delete(void* pointer) {
+	free(pointer);
+}
+
+void RequestToken::operator delete[](void* pointer) {
+	free(pointer);
 }
 
 void RequestToken::setCompleted(bool success) {
-	this->success.store(success);
-	this->completed.store(true);
+
+	// Waiters may delete or release the token as soon as the state is published, it must not be read afterwards
+	CompletionCallback completionCallback = this->completionCallback;
+	void *callbackContext = this->callbackContext;
+	RequestTokenPool *pool = this->releaseOnCompletion ? this->pool : NULL;
+
+	this->state.store(success ? (STATE_COMPLETED | STATE_SUCCESS) : STATE_COMPLETED);
+
+	if (completionCallback != NULL) {
+		completionCallback(this, callbackContext);
+	}
+	if (pool != NULL) {
+		pool->returnCompletedToken(this);
+	}
+
+}
+
+void RequestToken::setCompletionCallback(CompletionCallback completionCallback, void* callbackContext) {
+	this->completionCallback = completionCallback;
+	this->callbackContext = callbackContext;
+}
+
+void RequestToken::clearCompletionCallback() {
+	this->completionCallback = NULL;
+	this->callbackContext = NULL;
 }
 
 bool RequestToken::checkIfCompleted() {
-	if (this->completed.load()) {
+	if (this->state.load() & STATE_COMPLETED) {
 		return true;
+	} else if (this->completionQueueGroup->hasProgressEngine()) {
+		return false;
 	} else {
-		this->context->pollSendCompletionQueue();
-		return this->completed.load();
+		this->completionQueueGroup->pollSendCompletionQueue(infinity::core::Configuration::MAX_COMPLETION_BATCH_SIZE);
+		return (this->state.load() & STATE_COMPLETED) != 0;
 	}
 }
 
+bool RequestToken::isCompleted(void* requestToken) {
+	return (reinterpret_cast<RequestToken *>(requestToken)->state.load() & STATE_COMPLETED) != 0;
+}
+
 void RequestToken::waitUntilCompleted() {
-	while (!this->completed.load()) {
-		this->context->pollSendCompletionQueue();
+	if (!(this->state.load() & STATE_COMPLETED)) {
+		this->completionQueueGroup->waitForSendCompletions(&RequestToken::isCompleted, this);
 	}
 }
 
 bool RequestToken::wasSuccessful() {
-	return this->success.load();
+	return (this->state.load() & STATE_SUCCESS) != 0;
 }
 
 void RequestToken::reset() {
-	this->success.store(false);
-	this->completed.store(false);
+	this->state.store(0);
 	this->region = NULL;
 	this->userData = NULL;
 	this->userDataValid = false;
@@ -97,5 +157,9 @@ bool RequestToken::hasImmediateValue() {
 	return this->immediateValueValid;
 }
 
+RequestTokenPool* RequestToken::getPool() {
+	return this->pool;
+}
+
 } /* namespace requests */
 } /* namespace infinity */
@@ -10,20 +10,57 @@
 #define REQUESTS_REQUESTTOKEN_H_
 
 #include <atomic>
+#include <stddef.h>
 #include <stdint.h>
 
+#include <infinity/core/Configuration.h>
 #include <infinity/core/Context.h>
 #include <infinity/memory/Region.h>
 
+namespace infinity {
+namespace core {
+class CompletionQueueGroup;
+}
+namespace queues {
+class QueuePair;
+}
+}
+
 namespace infinity {
 namespace requests {
 
-class RequestToken {
+class RequestGroup;
+class RequestTokenPool;
+
+/**
+ * Tokens are aligned to cache lines, tokens completed by different threads do not share a line
+ */
+class alignas(infinity::core::Configuration::CACHE_LINE_SIZE) RequestToken {
+
+	friend class infinity::queues::QueuePair;
+	friend class infinity::requests::RequestGroup;
+	friend class infinity::requests::RequestTokenPool;
+
+public:
+
+	/**
+	 * Called by the thread which polls the completion, the token may be reused for the next operation from within the callback
+	 * (unless it is returned to its pool on completion)
+	 */
+	typedef void (*CompletionCallback)(RequestToken *requestToken, void *callbackContext);
 
 public:
 
 	RequestToken(infinity::core::Context *context);
 
+	/**
+	 * Heap allocated tokens keep their cache line alignment
+	 */
+	static void * operator new(size_t size);
+	static void * operator new[](size_t size);
+	static void operator delete(void *pointer);
+	static void operator delete[](void *pointer);
+
 	void reset();
 
 	void setRegion(infinity::memory::Region * region);
@@ -35,6 +72,12 @@ public:
 	bool checkIfCompleted();
 	void waitUntilCompleted();
 
+	/**
+	 * The callback is kept when the token is reset or reused
+	 */
+	void setCompletionCallback(CompletionCallback completionCallback, void *callbackContext);
+	void clearCompletionCallback();
+
 	void setImmediateValue(uint32_t immediateValue);
 	bool hasImmediateValue();
 	uint32_t getImmediateValue();
@@ -44,20 +87,47 @@ public:
 	void* getUserData();
 	uint32_t getUserDataSize();
 
+	/**
+	 * Pool the token was acquired from (NULL if it was created directly)
+	 */
+	RequestTokenPool * getPool();
+
 protected:
 
-	infinity::core::Context * const context;
+	static const uint32_t STATE_COMPLETED = 1;
+	static const uint32_t STATE_SUCCESS = 2;
+
+	/**
+	 * Completion condition used while waiting
+	 */
+	static bool isCompleted(void *requestToken);
+
+	/**
+	 * Written on completion, completed and success are published with a single store
+	 */
+	std::atomic<uint32_t> state;
+	infinity::core::CompletionQueueGroup * completionQueueGroup;
+	CompletionCallback completionCallback;
+	void *callbackContext;
+
+	/**
+	 * Written when the operation is posted
+	 */
 	infinity::memory::Region * region;
-
-	std::atomic<bool> completed;
-	std::atomic<bool> success;
-
-	void *userData;
-	uint32_t userDataSize;
-	bool userDataValid;
-
 	uint32_t immediateValue;
 	bool immediateValueValid;
+	bool userDataValid;
+	uint32_t userDataSize;
+	void *userData;
+
+	infinity::core::Context * const context;
+
+	/**
+	 * Pool membership
+	 */
+	RequestTokenPool *pool;
+	RequestToken *nextFreeToken;
+	bool releaseOnCompletion;
 
 };
 
@@ -0,0 +1,116 @@
+/**
+ * Requests - Request Token Pool
+ *
+ * (c) 2018 Claude Barthels, ETH Zurich
+ * Contact: claudeb@inf.ethz.ch
+ *
+ */
+
+#include "RequestTokenPool.h"
+
+#include <new>
+#include <stdlib.h>
+
+#include <infinity/utils/Debug.h>
+
+namespace infinity {
+namespace requests {
+
+RequestTokenPool::RequestTokenPool(infinity::core::Context* context, uint32_t tokensPerChunk) :
+		context(context), tokensPerChunk(tokensPerChunk) {
+
+	INFINITY_ASSERT(tokensPerChunk > 0, "[INFINITY][REQUESTS][POOL] Chunks must hold at least one token.\n");
+
+	this->freeTokens = NULL;
+	this->numberOfTokens = 0;
+	this->returnedTokens.store(NULL);
+
+}
+
+RequestTokenPool::~RequestTokenPool() {
+
+	for (uint64_t i = 0; i < this->chunks.size(); ++i) {
+		for (uint32_t j = 0; j < this->tokensPerChunk; ++j) {
+			this->chunks[i][j].~RequestToken();
+		}
+		free(this->chunks[i]);
+	}
+
+}
+
+RequestToken* RequestTokenPool::acquire(bool releaseOnCompletion) {
+
+	if (this->freeTokens == NULL) {
+		this->freeTokens = this->returnedTokens.exchange(NULL, std::memory_order_acquire);
+		if (this->freeTokens == NULL) {
+			allocateChunk();
+		}
+	}
+
+	RequestToken *requestToken = this->freeTokens;
+	this->freeTokens = requestToken->nextFreeToken;
+
+	requestToken->nextFreeToken = NULL;
+	requestToken->releaseOnCompletion = releaseOnCompletion;
+	requestToken->clearCompletionCallback();
+	requestToken->reset();
+
+	return requestToken;
+
+}
+
+void RequestTokenPool::release(RequestToken* requestToken) {
+
+	INFINITY_ASSERT(requestToken->pool == this, "[INFINITY][REQUESTS][POOL] Released token was not acquired from this pool.\n");
+
+	requestToken->releaseOnCompletion = false;
+	requestToken->nextFreeToken = this->freeTokens;
+	this->freeTokens = requestToken;
+
+}
+
+void RequestTokenPool::release(RequestToken** requestTokens, uint32_t numberOfTokens) {
+
+	for (uint32_t i = 0; i < numberOfTokens; ++i) {
+		release(requestTokens[i]);
+	}
+
+}
+
+uint64_t RequestTokenPool::getNumberOfTokens() {
+	return this->numberOfTokens;
+}
+
+void RequestTokenPool::allocateChunk() {
+
+	void *memory;
+	int returnValue = posix_memalign(&memory, infinity::core::Configuration::CACHE_LINE_SIZE, this->tokensPerChunk * sizeof(RequestToken));
+	INFINITY_ASSERT(returnValue == 0, "[INFINITY][REQUESTS][POOL] Cannot allocate memory for request tokens.\n");
+
+	RequestToken *tokens = reinterpret_cast<RequestToken *>(memory);
+	for (uint32_t i = 0; i < this->tokensPerChunk; ++i) {
+		::new (&tokens[i]) RequestToken(this->context);
+		tokens[i].pool = this;
+		tokens[i].nextFreeToken = (i + 1 < this->tokensPerChunk) ? &tokens[i + 1] : this->freeTokens;
+	}
+
+	this->chunks.push_back(tokens);
+	this->freeTokens = &tokens[0];
+	this->numberOfTokens += this->tokensPerChunk;
+
+	INFINITY_DEBUG("[INFINITY][REQUESTS][POOL] Allocated %u request tokens (%lu in total).\n", this->tokensPerChunk, this->numberOfTokens);
+
+}
+
+void RequestTokenPool::returnCompletedToken(RequestToken* requestToken) {
+
+	requestToken->releaseOnCompletion = false;
+	RequestToken *head = this->returnedTokens.load(std::memory_order_relaxed);
+	do {
+		requestToken->nextFreeToken = head;
+	} while (!this->returnedTokens.compare_exchange_weak(head, requestToken, std::memory_order_release, std::memory_order_relaxed));
+
+}
+
+} /* namespace requests */
+} /* namespace infinity */
@@ -0,0 +1,146 @@
+/**
+ * Utils - NUMA
+ *
+ * (c) 2018 Claude Barthels, ETH Zurich
+ * Contact: claudeb@inf.ethz.ch
+ *
+ */
+
+#include "Numa.h"
+
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+
+#include <infinity/core/Configuration.h>
+#include <infinity/utils/Debug.h>
+
+// Memory policy constants from numaif.h, libnuma is not required
+#define MPOL_PREFERRED 1
+#define MPOL_MF_MOVE (1 << 1)
+
+#define MAX_NUMBER_OF_NUMA_NODES 1024
+
+namespace infinity {
+namespace utils {
+
+int32_t Numa::getNumaNodeOfDevice(ibv_device* device) {
+
+	char path[IBV_SYSFS_PATH_MAX + 32];
+	snprintf(path, sizeof(path), "%s/device/numa_node", device->ibdev_path);
+
+	FILE *file = fopen(path, "r");
+	if (file == NULL) {
+		INFINITY_DEBUG("[INFINITY][UTILS][NUMA] Cannot read NUMA node of device %s.\n", ibv_get_device_name(device));
+		return -1;
+	}
+
+	int32_t numaNode = -1;
+	if (fscanf(file, "%d", &numaNode) != 1) {
+		numaNode = -1;
+	}
+	fclose(file);
+
+	return numaNode;
+
+}
+
+int32_t Numa::getCurrentNumaNode() {
+
+	uint32_t core;
+	uint32_t numaNode;
+	if (syscall(SYS_getcpu, &core, &numaNode, NULL) != 0) {
+		return -1;
+	}
+	return numaNode;
+
+}
+
+bool Numa::bindMemoryToNode(void* data, uint64_t sizeInBytes, int32_t numaNode) {
+
+	if (numaNode < 0 || numaNode >= MAX_NUMBER_OF_NUMA_NODES) {
+		return false;
+	}
+
+	unsigned long nodeMask[MAX_NUMBER_OF_NUMA_NODES / (8 * sizeof(unsigned long))];
+	memset(nodeMask, 0, sizeof(nodeMask));
+	nodeMask[numaNode / (8 * sizeof(unsigned long))] = 1UL << (numaNode % (8 * sizeof(unsigned long)));
+
+	// The range must start on a page boundary
+	uint64_t startAddress = reinterpret_cast<uint64_t>(data) & ~(static_cast<uint64_t>(infinity::core::Configuration::PAGE_SIZE) - 1);
+	uint64_t length = reinterpret_cast<uint64_t>(data) + sizeInBytes - startAddress;
+
+	long returnValue = syscall(SYS_mbind, startAddress, length, MPOL_PREFERRED, nodeMask, MAX_NUMBER_OF_NUMA_NODES + 1, MPOL_MF_MOVE);
+	if (returnValue != 0) {
+		INFINITY_DEBUG("[INFINITY][UTILS][NUMA] Cannot bind memory to NUMA node %d.\n", numaNode);
+		return false;
+	}
+	return true;
+
+}
+
+bool Numa::pinThreadToNode(int32_t numaNode) {
+
+	if (numaNode < 0) {
+		return false;
+	}
+
+	char path[64];
+	snprintf(path, sizeof(path), "/sys/devices/system/node/node%d/cpulist", numaNode);
+
+	FILE *file = fopen(path, "r");
+	if (file == NULL) {
+		INFINITY_DEBUG("[INFINITY][UTILS][NUMA] Cannot read core list of NUMA node %d.\n", numaNode);
+		return false;
+	}
+
+	// Core list has the form 0-7,16-23
+	cpu_set_t cpuSet;
+	CPU_ZERO(&cpuSet);
+	uint32_t firstCore;
+	uint32_t lastCore;
+	while (fscanf(file, "%u", &firstCore) == 1) {
+		lastCore = firstCore;
+		int separator = fgetc(file);
+		if (separator == '-') {
+			if (fscanf(file, "%u", &lastCore) != 1) {
+				break;
+			}
+			separator = fgetc(file);
+		}
+		for (uint32_t core = firstCore; core <= lastCore && core < CPU_SETSIZE; ++core) {
+			CPU_SET(core, &cpuSet);
+		}
+		if (separator != ',') {
+			break;
+		}
+	}
+	fclose(file);
+
+	if (CPU_COUNT(&cpuSet) == 0) {
+		return false;
+	}
+
+	return sched_setaffinity(0, sizeof(cpu_set_t), &cpuSet) == 0;
+
+}
+
+bool Numa::pinThreadToCore(uint32_t core) {
+
+	if (core >= CPU_SETSIZE) {
+		return false;
+	}
+
+	cpu_set_t cpuSet;
+	CPU_ZERO(&cpuSet);
+	CPU_SET(core, &cpuSet);
+
+	return sched_setaffinity(0, sizeof(cpu_set_t), &cpuSet) == 0;
+
+}
+
+} /* namespace utils */
+} /* namespace infinity */